@@ -0,0 +1,87 @@
+#pragma once
+
+#ifndef OWL_BENCHMARK_H
+#define OWL_BENCHMARK_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace owl::benchmark {
+    // incremented by the replaced global operator new in main.cpp
+    inline std::atomic<std::uint64_t> allocations{ 0 };
+
+    struct case_type {
+        std::string name;
+        // items processed by one call of run, used for the throughput column
+        std::size_t items;
+        std::function<void()> run;
+    };
+
+    struct result {
+        std::string name;
+        double ns_per_op;
+        double items_per_second;
+        double allocations_per_op;
+        std::uint64_t iterations;
+    };
+
+    inline std::vector<case_type>& registry() {
+        static std::vector<case_type> cases;
+        return cases;
+    }
+
+    struct registration {
+        registration(std::string name, std::size_t items, std::function<void()> run) {
+            registry().push_back({ std::move(name), items, std::move(run) });
+        }
+    };
+
+    // keeps the compiler from discarding a computed value
+    template <typename type> inline void keep(type&& value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "g"(&value) : "memory");
+#else
+        static volatile const void* sink;
+        sink = &value;
+#endif
+    }
+
+    // doubles the iteration count until one batch lasts at least min_time seconds
+    inline result measure(const case_type& c, double min_time) {
+        using clock = std::chrono::steady_clock;
+
+        c.run();
+        std::uint64_t iterations = 1;
+        while (true) {
+            auto allocated = allocations.load();
+            auto start = clock::now();
+            for (std::uint64_t i = 0; i < iterations; ++i) { c.run(); }
+            double elapsed = std::chrono::duration<double>(clock::now() - start).count();
+            auto allocated_per_batch = allocations.load() - allocated;
+
+            if (elapsed >= min_time || iterations >= (std::uint64_t(1) << 40)) {
+                double seconds_per_op = elapsed / iterations;
+                return {
+                    c.name,
+                    seconds_per_op * 1e9,
+                    seconds_per_op > 0 ? c.items / seconds_per_op : 0,
+                    static_cast<double>(allocated_per_batch) / iterations,
+                    iterations
+                };
+            }
+            iterations *= 2;
+        }
+    }
+}
+
+#define OWL_BENCHMARK_CONCAT_(a, b) a##b
+#define OWL_BENCHMARK_CONCAT(a, b) OWL_BENCHMARK_CONCAT_(a, b)
+#define OWL_BENCHMARK(name, items, ...) static owl::benchmark::registration OWL_BENCHMARK_CONCAT(owl_benchmark_, __LINE__)(name, items, __VA_ARGS__)
+
+#endif
\ No newline at end of file
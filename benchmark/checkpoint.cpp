@@ -0,0 +1,46 @@
+#include "benchmark.h"
+
+#include <owl/checkpoint.h>
+
+#include <random>
+#include <string>
+
+namespace {
+    using owl::benchmark::keep;
+
+    // 1000 scenarios of 30 years of monthly values, about 2.9 MB
+    const std::size_t scenarios = 1000, periods = 360;
+
+    const owl::math::ndarray<double, 2>& values() {
+        static owl::math::ndarray<double, 2> v = [] {
+            owl::math::ndarray<double, 2> v({ scenarios, periods });
+            std::mt19937_64 generator(42);
+            std::normal_distribution<double> normal(100, 15);
+            for (auto& x : v) { x = normal(generator); }
+            return v;
+        }();
+        return v;
+    }
+
+    // written once up front so the read cases also run on their own under --filter
+    const std::string& path() {
+        static std::string p = [] {
+            std::string p = (std::filesystem::temp_directory_path() / "owl_benchmark.ckpt").string();
+            owl::checkpoint::save(p, values());
+            return p;
+        }();
+        return p;
+    }
+
+    OWL_BENCHMARK("checkpoint/save/1000x360", scenarios * periods, [] { owl::checkpoint::save(path(), values()); });
+
+    OWL_BENCHMARK("checkpoint/open/1000x360", scenarios * periods, [] {
+        owl::checkpoint::reader in(path());
+        keep(in.view<double, 2>()(scenarios - 1, periods - 1));
+    });
+
+    OWL_BENCHMARK("checkpoint/verify/1000x360", scenarios * periods, [] {
+        static const owl::checkpoint::reader in(path());
+        keep(in.verify());
+    });
+}
\ No newline at end of file
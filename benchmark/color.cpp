@@ -0,0 +1,55 @@
+#include "benchmark.h"
+
+#include <owl/color.h>
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    using owl::benchmark::keep;
+
+    // one color per bus of a network map
+    const int buses = 10000;
+
+    OWL_BENCHMARK("color/interpolate/10k", buses, [] {
+        owl::color::Color a(0, 0, 255), b(255, 0, 0);
+        int checksum = 0;
+        for (int i = 0; i < buses; ++i) {
+            auto c = owl::color::interpolate(a, b, static_cast<double>(i) / buses);
+            checksum += c.r + c.g + c.b;
+        }
+        keep(checksum);
+    });
+
+    // a bus x hour heatmap of a monthly report
+    const std::size_t cells = 2000 * 744;
+
+    const std::vector<double>& loading() {
+        static std::vector<double> v = [] {
+            std::vector<double> v(cells);
+            std::mt19937_64 generator(42);
+            std::uniform_real_distribution<double> uniform(0, 1.2);
+            for (auto& x : v) { x = uniform(generator); }
+            return v;
+        }();
+        return v;
+    }
+
+    OWL_BENCHMARK("color/gradient/map/1.5M", cells, [] {
+        static const owl::color::gradient gradient({ "#2166ac", "#f7f7f7", "#b2182b" }, 4096);
+        static std::vector<std::uint32_t> out(cells);
+        gradient.map(loading().data(), cells, out.data(), 0, 1.2);
+        keep(out);
+    });
+
+    OWL_BENCHMARK("color/format_hex", 1, [] {
+        char hex[7];
+        owl::color::format_hex(0x1f77b4, hex);
+        keep(hex);
+    });
+
+    OWL_BENCHMARK("color/toRGB", 1, [] { keep(owl::color::toRGB("#1f77b4")); });
+    OWL_BENCHMARK("color/toHEX", 1, [] { keep(owl::color::toHEX(owl::color::Color(31, 119, 180))); });
+}
\ No newline at end of file
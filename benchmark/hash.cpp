@@ -0,0 +1,76 @@
+#include "benchmark.h"
+
+#include <owl/hash.h>
+
+#include <algorithm>
+#include <random>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    using owl::benchmark::keep;
+
+    using key = std::tuple<int, int, int>;
+
+    // (bus, block, scenario) keys as produced by a dense bus x block x scenario loop
+    const std::vector<key>& keys() {
+        static std::vector<key> keys = [] {
+            const int buses = 1000, blocks = 24, scenarios = 50;
+            std::vector<key> keys;
+            keys.reserve(buses * blocks * scenarios);
+            for (int scenario = 0; scenario < scenarios; ++scenario) {
+                for (int block = 0; block < blocks; ++block) {
+                    for (int bus = 0; bus < buses; ++bus) { keys.emplace_back(bus, block, scenario); }
+                }
+            }
+            return keys;
+        }();
+        return keys;
+    }
+
+    const std::vector<key>& queries() {
+        static std::vector<key> queries = [] {
+            std::vector<key> queries = keys();
+            std::shuffle(queries.begin(), queries.end(), std::mt19937(42));
+            return queries;
+        }();
+        return queries;
+    }
+
+    template <typename map_type> void insert() {
+        map_type map;
+        auto& k = keys();
+        for (std::size_t i = 0; i < k.size(); ++i) { map[k[i]] = static_cast<double>(i); }
+        keep(map);
+    }
+
+    template <typename map_type> void lookup() {
+        static const map_type map = [] {
+            map_type map;
+            auto& k = keys();
+            for (std::size_t i = 0; i < k.size(); ++i) { map[k[i]] = static_cast<double>(i); }
+            return map;
+        }();
+
+        double checksum = 0;
+        for (auto& k : queries()) {
+            auto it = map.find(k);
+            if (it != map.end()) { checksum += it->second; }
+        }
+        keep(checksum);
+    }
+
+    const std::size_t size = 1000 * 24 * 50;
+
+    OWL_BENCHMARK("hash/tuple/1.2M", size, [] {
+        std::size_t seed = 0;
+        for (auto& k : keys()) { seed ^= owl::hash::tuple_hash{}(k); }
+        keep(seed);
+    });
+
+    OWL_BENCHMARK("hash/unordered_map/insert/1.2M", size, insert<std::unordered_map<key, double, owl::hash::tuple_hash>>);
+    OWL_BENCHMARK("hash/unordered_map/lookup/1.2M", size, lookup<std::unordered_map<key, double, owl::hash::tuple_hash>>);
+    OWL_BENCHMARK("hash/flat_map/insert/1.2M", size, insert<owl::hash::flat_map<key, double>>);
+    OWL_BENCHMARK("hash/flat_map/lookup/1.2M", size, lookup<owl::hash::flat_map<key, double>>);
+}
\ No newline at end of file
@@ -0,0 +1,9 @@
+#include "benchmark.h"
+
+#include <owl/instrument.h>
+
+namespace {
+    OWL_BENCHMARK("instrument/scoped_timer", 1, [] { OWL_SCOPED_TIMER("benchmark"); });
+    OWL_BENCHMARK("instrument/count", 1, [] { OWL_COUNT("benchmark", 1); });
+    OWL_BENCHMARK("instrument/observe", 1, [] { OWL_OBSERVE("benchmark", 1000.0); });
+}
\ No newline at end of file
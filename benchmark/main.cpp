@@ -0,0 +1,137 @@
+// g++ -std=c++17 -O2 -I. benchmark/*.cpp -o owl_benchmark -pthread
+//
+// ./owl_benchmark [--filter text] [--min-time seconds] [--json out.json] [--baseline base.json] [--threshold 0.10]
+//
+// with --baseline, every case slower than its baseline ns/op by more than threshold is reported and the exit code is 1
+
+#include "benchmark.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <new>
+#include <string>
+#include <vector>
+
+void* operator new(std::size_t size) {
+    owl::benchmark::allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) { return p; }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    owl::benchmark::allocations.fetch_add(1, std::memory_order_relaxed);
+    auto align = static_cast<std::size_t>(alignment);
+    if (void* p = std::aligned_alloc(align, ((size + align - 1) / align) * align)) { return p; }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+// reads back the files written by write_json: one case per line
+std::map<std::string, double> read_baseline(const std::string& path) {
+    std::map<std::string, double> baseline;
+    std::ifstream file(path);
+    if (!file) {
+        std::fprintf(stderr, "cannot open baseline %s\n", path.c_str());
+        std::exit(2);
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        auto name = line.find("\"name\": \"");
+        auto ns = line.find("\"ns_per_op\": ");
+        if (name == std::string::npos || ns == std::string::npos) { continue; }
+
+        name += 9;
+        baseline[line.substr(name, line.find('"', name) - name)] = std::strtod(line.c_str() + ns + 13, nullptr);
+    }
+    return baseline;
+}
+
+void write_json(const std::string& path, const std::vector<owl::benchmark::result>& results) {
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        std::fprintf(stderr, "cannot write %s\n", path.c_str());
+        std::exit(2);
+    }
+
+    std::fprintf(file, "[\n");
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        auto& r = results[i];
+        std::fprintf(file, "  {\"name\": \"%s\", \"ns_per_op\": %.3f, \"items_per_second\": %.1f, \"allocations_per_op\": %.3f, \"iterations\": %llu}%s\n",
+            r.name.c_str(), r.ns_per_op, r.items_per_second, r.allocations_per_op, static_cast<unsigned long long>(r.iterations), i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(file, "]\n");
+    std::fclose(file);
+}
+
+int main(int argc, char** argv) {
+    std::string filter, json, baseline_path;
+    double min_time = 0.2, threshold = 0.10;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "missing value for %s\n", arg.c_str());
+            return 2;
+        }
+
+        if (arg == "--filter") {
+            filter = argv[++i];
+        } else if (arg == "--min-time") {
+            min_time = std::atof(argv[++i]);
+        } else if (arg == "--json") {
+            json = argv[++i];
+        } else if (arg == "--baseline") {
+            baseline_path = argv[++i];
+        } else if (arg == "--threshold") {
+            threshold = std::atof(argv[++i]);
+        } else {
+            std::fprintf(stderr, "unknown option %s\n", arg.c_str());
+            return 2;
+        }
+    }
+
+    std::map<std::string, double> baseline;
+    if (!baseline_path.empty()) { baseline = read_baseline(baseline_path); }
+
+    std::vector<owl::benchmark::result> results;
+    int regressions = 0;
+
+    std::printf("%-40s %14s %16s %12s %10s\n", "case", "ns/op", "items/s", "allocs/op", "baseline");
+    for (auto& c : owl::benchmark::registry()) {
+        if (!filter.empty() && c.name.find(filter) == std::string::npos) { continue; }
+
+        auto r = owl::benchmark::measure(c, min_time);
+        results.push_back(r);
+
+        std::string change;
+        auto it = baseline.find(r.name);
+        if (it != baseline.end() && it->second > 0) {
+            double ratio = r.ns_per_op / it->second - 1;
+            char buffer[32];
+            std::snprintf(buffer, sizeof buffer, "%+.1f%%", ratio * 100);
+            change = buffer;
+            if (ratio > threshold) {
+                change += " REGRESSION";
+                ++regressions;
+            }
+        }
+
+        std::printf("%-40s %14.1f %16.4g %12.2f %10s\n", r.name.c_str(), r.ns_per_op, r.items_per_second, r.allocations_per_op, change.c_str());
+        std::fflush(stdout);
+    }
+
+    if (!json.empty()) { write_json(json, results); }
+
+    if (regressions > 0) {
+        std::printf("%d case(s) regressed by more than %.0f%%\n", regressions, threshold * 100);
+        return 1;
+    }
+    return 0;
+}
\ No newline at end of file
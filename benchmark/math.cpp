@@ -0,0 +1,99 @@
+#include "benchmark.h"
+
+#include <owl/math.h>
+#include <owl/math_thread_pool.h>
+
+#include <random>
+#include <vector>
+
+namespace {
+    using owl::benchmark::keep;
+
+    // a typical scenario count times a few stages
+    const std::size_t size = 1 << 20;
+
+    std::vector<double>& samples() {
+        static std::vector<double> v = [] {
+            std::vector<double> v(size);
+            std::mt19937_64 generator(42);
+            std::normal_distribution<double> normal(100, 15);
+            for (auto& x : v) { x = normal(generator); }
+            return v;
+        }();
+        return v;
+    }
+
+    // 2000 scenarios of a risk-measure evaluation
+    std::vector<double>& scenarios() {
+        static std::vector<double> v(samples().begin(), samples().begin() + 2000);
+        return v;
+    }
+
+    // a hydro production function table and the targets looked up in it
+    std::vector<double>& table() {
+        static std::vector<double> v(samples().begin(), samples().begin() + 500);
+        return v;
+    }
+
+    std::vector<double>& targets() {
+        static std::vector<double> v(samples().end() - 10000, samples().end());
+        return v;
+    }
+
+    OWL_BENCHMARK("math/sum/1M", size, [] { keep(owl::math::sum(samples())); });
+    OWL_BENCHMARK("math/sum/1M/parallel", size, [] { keep(owl::math::sum(samples(), owl::math::execution::parallel)); });
+    OWL_BENCHMARK("math/average/1M", size, [] { keep(owl::math::average(samples())); });
+    OWL_BENCHMARK("math/minimum/1M", size, [] { keep(owl::math::minimum(samples())); });
+    OWL_BENCHMARK("math/maximum/1M", size, [] { keep(owl::math::maximum(samples())); });
+    OWL_BENCHMARK("math/stddev/1M", size, [] { keep(owl::math::stddev(samples())); });
+    OWL_BENCHMARK("math/npv/1M", size, [] { keep(owl::math::npv(samples(), 0.08)); });
+
+    // 5000 candidate projects over 30 years of monthly cash flows, at four discount rates
+    OWL_BENCHMARK("math/npv/batched/5000x360x4", 5000 * 4, [] {
+        static const std::vector<double> rates = { 0.06, 0.08, 0.10, 0.12 };
+        static const std::vector<double> flows = [] {
+            std::vector<double> flows;
+            while (flows.size() < 5000 * 360) { flows.insert(flows.end(), samples().begin(), samples().end()); }
+            flows.resize(5000 * 360);
+            return flows;
+        }();
+        static std::vector<double> out(5000 * rates.size());
+        owl::math::npv(flows.data(), 5000, 360, rates.data(), rates.size(), out.data());
+        keep(out);
+    });
+
+    OWL_BENCHMARK("math/accumulator/1M", size, [] {
+        owl::math::accumulator a;
+        a.add(samples());
+        keep(a.variance());
+    });
+
+    OWL_BENCHMARK("math/approximately_equal/1M", size, [] {
+        static const std::vector<double> previous = [] {
+            std::vector<double> v = samples();
+            for (auto& x : v) { x *= 1 + 1e-6; }
+            return v;
+        }();
+        static owl::algorithm::bitmask converged;
+        owl::math::approximately_equal(samples().data(), previous.data(), size, converged);
+        keep(converged.all());
+    });
+
+    OWL_BENCHMARK("math/quantile/2k", 2000, [] { keep(owl::math::quantile(scenarios(), 0.95)); });
+    OWL_BENCHMARK("math/cvar/2k", 2000, [] { keep(owl::math::cvar(scenarios(), 0.05)); });
+
+    OWL_BENCHMARK("math/risk_measures/2k/x4", 2000, [] {
+        static const std::vector<double> alphas = { 0.01, 0.05, 0.10, 0.25 };
+        keep(owl::math::risk_measures(scenarios(), alphas));
+    });
+
+    OWL_BENCHMARK("math/find_nearest/500", 1, [] {
+        static std::size_t i = 0;
+        keep(owl::math::find_nearest(table(), targets()[i++ % targets().size()]));
+    });
+
+    OWL_BENCHMARK("math/nearest_lookup/500/x10k", 10000, [] {
+        static const owl::math::nearest_lookup lookup(table());
+        keep(lookup.find(targets()));
+    });
+}
\ No newline at end of file
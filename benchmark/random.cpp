@@ -0,0 +1,34 @@
+#include "benchmark.h"
+
+#include <owl/random.h>
+#include <owl/string.h>
+
+#include <vector>
+
+namespace {
+    using owl::benchmark::keep;
+
+    // one inflow sample per scenario and stage
+    const std::size_t size = 1 << 20;
+
+    OWL_BENCHMARK("random/fill_uniform/1M", size, [] {
+        static owl::random::generator generator(42);
+        static std::vector<double> v(size);
+        generator.fill_uniform(v);
+        keep(v);
+    });
+
+    OWL_BENCHMARK("random/fill_normal/1M", size, [] {
+        static owl::random::generator generator(42);
+        static std::vector<double> v(size);
+        generator.fill_normal(v);
+        keep(v);
+    });
+
+    OWL_BENCHMARK("random/stream", 1, [] {
+        static std::uint64_t scenario = 0;
+        keep(owl::random::stream(42, scenario++));
+    });
+
+    OWL_BENCHMARK("string/random_string/16", 16, [] { keep(owl::string::random_string()); });
+}
\ No newline at end of file
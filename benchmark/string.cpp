@@ -0,0 +1,87 @@
+#include "benchmark.h"
+
+#include <owl/csv.h>
+#include <owl/string.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    using owl::benchmark::keep;
+
+    const std::size_t rows = 1000, fields = 24;
+
+    // one csv row per stage: a label followed by 24 hourly values
+    const std::string& line() {
+        static std::string s = [] {
+            std::string s = "thermal plant 001";
+            std::mt19937_64 generator(42);
+            std::uniform_real_distribution<double> uniform(0, 500);
+            for (std::size_t i = 0; i < fields; ++i) { s += "," + std::to_string(uniform(generator)); }
+            return s;
+        }();
+        return s;
+    }
+
+    const std::string& file() {
+        static std::string s = [] {
+            std::string s;
+            for (std::size_t i = 0; i < rows; ++i) { s += line() + "\n"; }
+            return s;
+        }();
+        return s;
+    }
+
+    const std::vector<double>& values() {
+        static std::vector<double> v = [] {
+            std::vector<double> v(rows);
+            std::mt19937_64 generator(7);
+            std::uniform_real_distribution<double> uniform(-1e3, 1e3);
+            for (auto& x : v) { x = uniform(generator); }
+            return v;
+        }();
+        return v;
+    }
+
+    OWL_BENCHMARK("string/split/char/25", fields + 1, [] { keep(owl::string::split(line(), ',')); });
+    OWL_BENCHMARK("string/split/string/25", fields + 1, [] { keep(owl::string::split(line(), std::string(","))); });
+
+    OWL_BENCHMARK("string/split_view/25", fields + 1, [] {
+        static std::vector<std::string_view> tokens;
+        owl::string::split_view(line(), ',', tokens);
+        keep(tokens);
+    });
+
+    OWL_BENCHMARK("string/join/1k", rows, [] { keep(owl::string::join(values())); });
+    OWL_BENCHMARK("string/join_with_precision/1k", rows, [] { keep(owl::string::join_with_precision(values())); });
+
+    OWL_BENCHMARK("string/trim/25", 1, [] { keep(owl::string::trim("   " + line() + "  ")); });
+
+    // 1000 plant names as read from a case file: almost all plain ASCII, one in ten accented
+    std::vector<std::string>& names() {
+        static std::vector<std::string> v = [] {
+            std::vector<std::string> v(rows);
+            for (std::size_t i = 0; i < rows; ++i) { v[i] = (i % 10 == 0 ? "usina s\xe3o jo\xe3o " : "thermal plant ") + std::to_string(i); }
+            return v;
+        }();
+        return v;
+    }
+
+    OWL_BENCHMARK("string/ansi_to_utf8/1k", rows, [] {
+        for (const auto& name : names()) { keep(owl::string::ansi_to_utf8(name)); }
+    });
+
+    OWL_BENCHMARK("string/ansi_to_utf8/batch/1k", rows, [] {
+        static std::vector<std::string> v;
+        v = names();
+        owl::string::ansi_to_utf8(v);
+        keep(v);
+    });
+
+    OWL_BENCHMARK("csv/read_columns/1k", rows, [] {
+        static const std::vector<std::size_t> indices = { 1, 12, 24 };
+        static std::vector<std::vector<double>> columns;
+        keep(owl::csv::read_columns(file(), ',', indices, columns));
+    });
+}
\ No newline at end of file
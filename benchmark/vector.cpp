@@ -0,0 +1,114 @@
+#include "benchmark.h"
+
+#include <owl/algorithm.h>
+#include <owl/convert.h>
+#include <owl/datetime.h>
+#include <owl/vector.h>
+
+#include <random>
+#include <vector>
+
+namespace {
+    using owl::benchmark::keep;
+
+    const std::size_t size = 100000;
+
+    // bus ids of a contingency list, with repetitions
+    const std::vector<int>& ids() {
+        static std::vector<int> v = [] {
+            std::vector<int> v(size);
+            std::mt19937 generator(42);
+            std::uniform_int_distribution<int> uniform(0, 20000);
+            for (auto& x : v) { x = uniform(generator); }
+            return v;
+        }();
+        return v;
+    }
+
+    OWL_BENCHMARK("vector/remove_duplicates/100k", size, [] {
+        std::vector<int> v = ids();
+        owl::vector::remove_duplicates(v);
+        keep(v);
+    });
+
+    OWL_BENCHMARK("vector/sort_unique/100k", size, [] {
+        std::vector<int> v = ids();
+        owl::vector::sort_unique(v);
+        keep(v);
+    });
+
+    OWL_BENCHMARK("vector/has/100k", size, [] {
+        static const std::vector<int> v = ids();
+        keep(owl::vector::has(v, -1));
+    });
+
+    OWL_BENCHMARK("vector/flat_set/build/100k", size, [] { keep(owl::vector::flat_set<int>(ids())); });
+
+    OWL_BENCHMARK("vector/flat_set/contains/100k", size, [] {
+        static const owl::vector::flat_set<int> s(ids());
+        std::size_t found = 0;
+        for (auto id : ids()) { found += s.contains(id + 1); }
+        keep(found);
+    });
+
+    OWL_BENCHMARK("vector/flat_set/intersection/100k", size, [] {
+        static const owl::vector::flat_set<int> a(ids());
+        static const owl::vector::flat_set<int> b(ids().rbegin(), ids().rbegin() + size / 2);
+        keep(owl::vector::set_intersection(a, b));
+    });
+
+    OWL_BENCHMARK("algorithm/all_true/100k", size, [] {
+        static const std::vector<bool> v(size, true);
+        keep(owl::algorithm::all_true(v));
+    });
+
+    OWL_BENCHMARK("algorithm/bitmask/all/100k", size, [] {
+        static const owl::algorithm::bitmask m(size, true);
+        keep(owl::algorithm::all_true(m));
+    });
+
+    OWL_BENCHMARK("algorithm/bitmask/count/100k", size, [] {
+        static const owl::algorithm::bitmask m(std::vector<bool>(ids().begin(), ids().end()));
+        keep(m.count());
+    });
+
+    OWL_BENCHMARK("convert/mw_to_pu/100k", size, [] {
+        static std::vector<double> v(size, 250.0);
+        for (auto& x : v) { x = owl::convert::pu_to_mw(owl::convert::mw_to_pu(x)); }
+        keep(v);
+    });
+
+    OWL_BENCHMARK("convert/mw_to_pu/bulk/100k", size, [] {
+        static std::vector<double> v(size, 250.0);
+        owl::convert::mw_to_pu_inplace(v);
+        owl::convert::pu_to_mw_inplace(v);
+        keep(v);
+    });
+
+    OWL_BENCHMARK("datetime/is_leap_year/400", 400, [] {
+        int leap = 0;
+        for (int year = 1800; year < 2200; ++year) { leap += owl::datetime::is_leap_year(year); }
+        keep(leap);
+    });
+
+    // every hour of a 30-year horizon
+    OWL_BENCHMARK("datetime/to_date/263k", 263000, [] {
+        static const owl::datetime::calendar calendar(2025, 2054);
+        // 30 years hold 262968 hours; the tail wraps around to the start of the horizon
+        static std::vector<int> hours = [] {
+            std::vector<int> hours(263000);
+            for (std::size_t i = 0; i < hours.size(); ++i) { hours[i] = static_cast<int>(i) % calendar.hours(); }
+            return hours;
+        }();
+        static std::vector<owl::datetime::date_hour> dates(hours.size());
+        calendar.to_date(hours.data(), hours.size(), dates.data());
+        keep(dates);
+    });
+
+    OWL_BENCHMARK("datetime/mean_by_range/monthly/263k", 263000, [] {
+        static const owl::datetime::calendar calendar(2025, 2054);
+        static const std::vector<owl::datetime::hour_range> months = calendar.month_ranges();
+        static const std::vector<double> hourly(calendar.hours(), 1.0);
+        keep(owl::datetime::mean_by_range(hourly, months));
+    });
+}
\ No newline at end of file
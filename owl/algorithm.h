@@ -3,17 +3,189 @@
 #ifndef OWL_ALGORITHM_H
 #define OWL_ALGORITHM_H
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 namespace owl::algorithm {
-    inline bool all_true(std::vector<bool>& v) {
-        for (auto i : v) { if (!i) { return false; } }
-        return true;
+    inline int popcount(std::uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(word);
+#else
+        int count = 0;
+        for (; word != 0; word &= word - 1) { ++count; }
+        return count;
+#endif
     }
 
-    inline bool all_false(std::vector<bool>& v) {
-        for (auto i : v) { if (i) { return false; } }
-        return true;
+    inline int countr_zero(std::uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(word);
+#else
+        int count = 0;
+        for (; (word & 1) == 0; word >>= 1) { ++count; }
+        return count;
+#endif
+    }
+
+    // fixed-size packed bit array, 64 flags per word; bits past size() in the last word are always zero, so whole-mask
+    // queries are plain word loops
+    class bitmask {
+    public:
+        bitmask() = default;
+
+        explicit bitmask(std::size_t size, bool value = false) {
+            resize(size, value);
+        }
+
+        explicit bitmask(const std::vector<bool>& v) : bitmask(v.size()) {
+            for (std::size_t i = 0; i < v.size(); ++i) {
+                if (v[i]) { set(i); }
+            }
+        }
+
+        static constexpr std::size_t bits = 64;
+
+        static std::size_t words_for(std::size_t size) { return (size + bits - 1) / bits; }
+
+        std::size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+
+        std::size_t word_count() const { return words_.size(); }
+        std::uint64_t* data() { return words_.data(); }
+        const std::uint64_t* data() const { return words_.data(); }
+
+        void resize(std::size_t size, bool value = false) {
+            std::size_t old = size_;
+            if (value && old % bits != 0 && !words_.empty()) { words_.back() |= ~std::uint64_t(0) << (old % bits); }
+            words_.resize(words_for(size), value ? ~std::uint64_t(0) : 0);
+            size_ = size;
+            trim();
+        }
+
+        bool test(std::size_t i) const { return (words_[i / bits] >> (i % bits)) & 1; }
+        bool operator[](std::size_t i) const { return test(i); }
+
+        void set(std::size_t i) { words_[i / bits] |= std::uint64_t(1) << (i % bits); }
+        void set(std::size_t i, bool value) { value ? set(i) : reset(i); }
+        void reset(std::size_t i) { words_[i / bits] &= ~(std::uint64_t(1) << (i % bits)); }
+        void flip(std::size_t i) { words_[i / bits] ^= std::uint64_t(1) << (i % bits); }
+
+        void set_all() {
+            std::fill(words_.begin(), words_.end(), ~std::uint64_t(0));
+            trim();
+        }
+
+        void reset_all() { std::fill(words_.begin(), words_.end(), 0); }
+
+        bool all() const {
+            if (words_.empty()) { return true; }
+            for (std::size_t w = 0; w + 1 < words_.size(); ++w) {
+                if (words_[w] != ~std::uint64_t(0)) { return false; }
+            }
+            return words_.back() == tail();
+        }
+
+        bool any() const {
+            for (auto word : words_) {
+                if (word != 0) { return true; }
+            }
+            return false;
+        }
+
+        bool none() const { return !any(); }
+
+        std::size_t count() const {
+            std::size_t count = 0;
+            for (auto word : words_) { count += popcount(word); }
+            return count;
+        }
+
+        // calls f(i) for every set bit, in increasing order
+        template <typename function> void for_each_set(function f) const {
+            for (std::size_t w = 0; w < words_.size(); ++w) {
+                for (std::uint64_t word = words_[w]; word != 0; word &= word - 1) { f(w * bits + countr_zero(word)); }
+            }
+        }
+
+        std::vector<std::size_t> indices() const {
+            std::vector<std::size_t> result;
+            result.reserve(count());
+            for_each_set([&result](std::size_t i) { result.push_back(i); });
+            return result;
+        }
+
+        std::vector<bool> to_vector() const {
+            std::vector<bool> v(size_);
+            for_each_set([&v](std::size_t i) { v[i] = true; });
+            return v;
+        }
+
+        // masks combined with each other must have the same size
+        bitmask& operator&=(const bitmask& other) {
+            for (std::size_t w = 0; w < words_.size(); ++w) { words_[w] &= other.words_[w]; }
+            return *this;
+        }
+
+        bitmask& operator|=(const bitmask& other) {
+            for (std::size_t w = 0; w < words_.size(); ++w) { words_[w] |= other.words_[w]; }
+            return *this;
+        }
+
+        bitmask& operator^=(const bitmask& other) {
+            for (std::size_t w = 0; w < words_.size(); ++w) { words_[w] ^= other.words_[w]; }
+            return *this;
+        }
+
+        // clears the bits set in other
+        bitmask& subtract(const bitmask& other) {
+            for (std::size_t w = 0; w < words_.size(); ++w) { words_[w] &= ~other.words_[w]; }
+            return *this;
+        }
+
+        bitmask operator~() const {
+            bitmask result(*this);
+            for (auto& word : result.words_) { word = ~word; }
+            result.trim();
+            return result;
+        }
+
+        friend bitmask operator&(bitmask a, const bitmask& b) { return a &= b; }
+        friend bitmask operator|(bitmask a, const bitmask& b) { return a |= b; }
+        friend bitmask operator^(bitmask a, const bitmask& b) { return a ^= b; }
+
+        bool operator==(const bitmask& other) const { return size_ == other.size_ && words_ == other.words_; }
+        bool operator!=(const bitmask& other) const { return !(*this == other); }
+
+    private:
+        // valid bits of the last word
+        std::uint64_t tail() const {
+            return size_ % bits == 0 ? ~std::uint64_t(0) : (std::uint64_t(1) << (size_ % bits)) - 1;
+        }
+
+        void trim() {
+            if (!words_.empty()) { words_.back() &= tail(); }
+        }
+
+        std::vector<std::uint64_t> words_;
+        std::size_t size_ = 0;
+    };
+
+    inline bool all_true(const std::vector<bool>& v) {
+        return std::find(v.begin(), v.end(), false) == v.end();
+    }
+
+    inline bool all_false(const std::vector<bool>& v) {
+        return std::find(v.begin(), v.end(), true) == v.end();
+    }
+
+    inline bool all_true(const bitmask& m) {
+        return m.all();
+    }
+
+    inline bool all_false(const bitmask& m) {
+        return m.none();
     }
 }
 
@@ -0,0 +1,335 @@
+#pragma once
+
+#ifndef OWL_CHECKPOINT_H
+#define OWL_CHECKPOINT_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <owl/filesystem.h>
+#include <owl/hash.h>
+#include <owl/ndarray.h>
+
+namespace owl::checkpoint {
+    // On-disk layout: a 128-byte header followed by the elements in row-major order, native byte order. A "row" is
+    // one index along the first axis; rows sit at fixed offsets, so a file can be written by rows in any order or by
+    // several processes at once, and read back by row ranges of any split. The checksum is the wrapping sum of
+    // per-row hashes keyed by row index, so partial checksums of disjoint row ranges add up to the whole
+    enum class dtype : std::uint32_t { float64 = 1, float32 = 2, int64 = 3, int32 = 4, uint64 = 5, uint32 = 6, uint8 = 7 };
+
+    // the stored dtype follows kind, size and signedness rather than the exact type, so long and long long (one of which
+    // is std::int64_t) both map to int64
+    template <typename type> struct dtype_of {
+        static_assert(std::is_arithmetic_v<type> && !std::is_same_v<type, bool>, "owl::checkpoint: unsupported element type");
+        static_assert(std::is_floating_point_v<type> ? (sizeof(type) == 8 || sizeof(type) == 4)
+                      : std::is_signed_v<type> ? (sizeof(type) == 8 || sizeof(type) == 4)
+                                               : (sizeof(type) == 8 || sizeof(type) == 4 || sizeof(type) == 1),
+                      "owl::checkpoint: no dtype of this size");
+
+        static constexpr dtype value = std::is_floating_point_v<type> ? (sizeof(type) == 8 ? dtype::float64 : dtype::float32)
+                                       : std::is_signed_v<type>       ? (sizeof(type) == 8 ? dtype::int64 : dtype::int32)
+                                       : sizeof(type) == 8            ? dtype::uint64
+                                       : sizeof(type) == 4            ? dtype::uint32
+                                                                      : dtype::uint8;
+    };
+
+    inline std::size_t dtype_size(dtype t) {
+        switch (t) {
+            case dtype::float64:
+            case dtype::int64:
+            case dtype::uint64: return 8;
+            case dtype::float32:
+            case dtype::int32:
+            case dtype::uint32: return 4;
+            case dtype::uint8: return 1;
+        }
+        throw std::runtime_error("owl::checkpoint: unknown dtype");
+    }
+
+    constexpr char magic[8] = { 'O', 'W', 'L', 'C', 'K', 'P', 'T', '\0' };
+    constexpr std::uint32_t version = 1;
+    constexpr std::uint32_t endianness = 0x01020304;
+    constexpr std::size_t max_rank = 8;
+
+    struct header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t endianness;
+        std::uint32_t type;
+        std::uint32_t rank;
+        std::uint64_t shape[max_rank];
+        std::uint64_t checksum;
+        std::uint64_t reserved[4];
+
+        std::size_t rows() const { return static_cast<std::size_t>(shape[0]); }
+
+        // elements per row: the product of every extent but the first
+        std::size_t row_size() const {
+            std::size_t size = 1;
+            for (std::uint32_t axis = 1; axis < rank; ++axis) { size *= static_cast<std::size_t>(shape[axis]); }
+            return size;
+        }
+
+        std::size_t row_bytes() const { return row_size() * dtype_size(static_cast<dtype>(type)); }
+        std::size_t data_bytes() const { return rows() * row_bytes(); }
+    };
+
+    static_assert(sizeof(header) == 128, "owl::checkpoint::header must stay 128 bytes");
+    static_assert(std::is_trivially_copyable_v<header>, "owl::checkpoint::header is written as raw bytes");
+
+    template <typename type, std::size_t N> inline header make_header(const std::array<std::size_t, N>& shape) {
+        static_assert(N >= 1 && N <= max_rank, "owl::checkpoint: unsupported rank");
+        header h = {};
+        std::memcpy(h.magic, magic, sizeof(magic));
+        h.version = version;
+        h.endianness = endianness;
+        h.type = static_cast<std::uint32_t>(dtype_of<type>::value);
+        h.rank = static_cast<std::uint32_t>(N);
+        for (std::size_t axis = 0; axis < N; ++axis) { h.shape[axis] = shape[axis]; }
+        return h;
+    }
+
+    inline std::uint64_t row_checksum(std::size_t row, const void* data, std::size_t bytes) {
+        return owl::hash::mix(owl::hash::bytes(data, bytes, row));
+    }
+
+    // checksum of rows [first_row, first_row + count) laid out contiguously in data
+    inline std::uint64_t checksum(std::size_t first_row, const void* data, std::size_t count, std::size_t row_bytes) {
+        const char* p = static_cast<const char*>(data);
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i < count; ++i) { sum += row_checksum(first_row + i, p + i * row_bytes, row_bytes); }
+        return sum;
+    }
+
+    inline void validate(const header& h, std::size_t file_size, const std::string& path) {
+        if (std::memcmp(h.magic, magic, sizeof(magic)) != 0) { throw std::runtime_error("owl::checkpoint: " + path + " is not a checkpoint"); }
+        if (h.endianness != endianness) { throw std::runtime_error("owl::checkpoint: " + path + " was written with another byte order"); }
+        if (h.version != version) { throw std::runtime_error("owl::checkpoint: " + path + " has unsupported version " + std::to_string(h.version)); }
+        if (h.rank < 1 || h.rank > max_rank) { throw std::runtime_error("owl::checkpoint: " + path + " has invalid rank"); }
+        if (file_size != sizeof(header) + h.data_bytes()) { throw std::runtime_error("owl::checkpoint: " + path + " is truncated"); }
+    }
+
+    // creates path holding a zero-filled array of the given shape; the checksum is left at zero until finalize
+    inline void create(const std::string& path, const header& h) {
+        {
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            if (!file) { throw std::runtime_error("owl::checkpoint: cannot create " + path); }
+            file.write(reinterpret_cast<const char*>(&h), sizeof(header));
+            if (!file) { throw std::runtime_error("owl::checkpoint: cannot write " + path); }
+        }
+        std::filesystem::resize_file(path, sizeof(header) + h.data_bytes());
+    }
+
+    // stores the checksum of the whole file once every row has been written
+    inline void finalize(const std::string& path, std::uint64_t checksum) {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        if (!file) { throw std::runtime_error("owl::checkpoint: cannot open " + path); }
+        file.seekp(offsetof(header, checksum));
+        file.write(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+        if (!file) { throw std::runtime_error("owl::checkpoint: cannot write " + path); }
+    }
+
+    // Writes rows of an array to a checkpoint file without holding the array in memory. The owning constructor
+    // creates the file, and close() (or the destructor) stores the checksum once every row is written. The attaching
+    // constructor opens a file created elsewhere, as each MPI rank does for its own slice; it never touches the
+    // header, and partial() returns the checksum of its rows to be summed and passed to finalize(). Every row must be
+    // written exactly once
+    template <typename type, std::size_t N> class writer {
+    public:
+        using shape_type = std::array<std::size_t, N>;
+
+        writer(const std::string& path, const shape_type& shape) : path_(path), header_(make_header<type>(shape)), owner_(true) {
+            create(path_, header_);
+            open();
+        }
+
+        explicit writer(const std::string& path) : path_(path), owner_(false) {
+            std::ifstream file(path_, std::ios::binary);
+            if (!file || !file.read(reinterpret_cast<char*>(&header_), sizeof(header))) { throw std::runtime_error("owl::checkpoint: cannot read " + path_); }
+            file.close();
+            validate(header_, static_cast<std::size_t>(std::filesystem::file_size(path_)), path_);
+            if (header_.type != static_cast<std::uint32_t>(dtype_of<type>::value) || header_.rank != N) {
+                throw std::runtime_error("owl::checkpoint: " + path_ + " holds another dtype or rank");
+            }
+            open();
+        }
+
+        writer(const writer&) = delete;
+        writer& operator=(const writer&) = delete;
+
+        ~writer() {
+            try {
+                close();
+            } catch (...) {
+            }
+        }
+
+        std::size_t rows() const { return header_.rows(); }
+        std::size_t row_size() const { return header_.row_size(); }
+        std::uint64_t partial() const { return checksum_; }
+
+        // writes count rows, taken contiguously from data, starting at first_row
+        void write(std::size_t first_row, const type* data, std::size_t count) {
+            if (first_row + count > rows()) { throw std::out_of_range("owl::checkpoint::writer: rows out of range"); }
+            const std::size_t row_bytes = header_.row_bytes();
+            file_.seekp(static_cast<std::streamoff>(sizeof(header) + first_row * row_bytes));
+            file_.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(count * row_bytes));
+            if (!file_) { throw std::runtime_error("owl::checkpoint: cannot write " + path_); }
+            checksum_ += checksum(first_row, data, count, row_bytes);
+        }
+
+        // streams count rows right after the last appended row
+        void append(const type* data, std::size_t count) {
+            write(cursor_, data, count);
+            cursor_ += count;
+        }
+
+        void write(std::size_t first_row, owl::math::ndarray_view<const type, N> values) {
+            check_shape(values.shape());
+            if (values.contiguous()) { return write(first_row, values.data(), values.shape(0)); }
+
+            std::vector<type> buffer;
+            buffer.reserve(row_size());
+            for (std::size_t i = 0; i < values.shape(0); ++i) {
+                buffer.clear();
+                if constexpr (N == 1) {
+                    buffer.push_back(values[i]);
+                } else {
+                    values[i].for_each([&buffer](const type& x) { buffer.push_back(x); });
+                }
+                write(first_row + i, buffer.data(), 1);
+            }
+        }
+
+        void append(owl::math::ndarray_view<const type, N> values) {
+            write(cursor_, values);
+            cursor_ += values.shape(0);
+        }
+
+        void close() {
+            if (!file_.is_open()) { return; }
+            file_.close();
+            if (owner_) { finalize(path_, checksum_); }
+        }
+
+    private:
+        void open() {
+            file_.open(path_, std::ios::binary | std::ios::in | std::ios::out);
+            if (!file_) { throw std::runtime_error("owl::checkpoint: cannot open " + path_); }
+        }
+
+        void check_shape(const shape_type& shape) const {
+            if (shape[0] == 0) { return; }
+            for (std::size_t axis = 1; axis < N; ++axis) {
+                if (shape[axis] != header_.shape[axis]) { throw std::runtime_error("owl::checkpoint::writer: row shape mismatch"); }
+            }
+        }
+
+        std::string path_;
+        header header_;
+        bool owner_;
+        std::fstream file_;
+        std::size_t cursor_ = 0;
+        std::uint64_t checksum_ = 0;
+    };
+
+    // Memory-maps a checkpoint: view() and rows() point straight into the mapping, so nothing is read until it is
+    // touched and nothing is copied. Views stay valid while the reader lives. The checksum is only checked on verify(),
+    // which reads the whole file
+    class reader {
+    public:
+        explicit reader(const std::string& path) : path_(path), file_(path) {
+            if (file_.size() < sizeof(header)) { throw std::runtime_error("owl::checkpoint: " + path_ + " is not a checkpoint"); }
+            std::memcpy(&header_, file_.data(), sizeof(header));
+            validate(header_, file_.size(), path_);
+        }
+
+        const header& info() const { return header_; }
+        dtype type() const { return static_cast<dtype>(header_.type); }
+        std::size_t rank() const { return header_.rank; }
+        std::size_t rows() const { return header_.rows(); }
+
+        std::vector<std::size_t> shape() const {
+            return std::vector<std::size_t>(header_.shape, header_.shape + header_.rank);
+        }
+
+        template <typename value_type, std::size_t N> owl::math::ndarray_view<const value_type, N> view() const {
+            if (header_.type != static_cast<std::uint32_t>(dtype_of<value_type>::value) || header_.rank != N) {
+                throw std::runtime_error("owl::checkpoint: " + path_ + " holds another dtype or rank");
+            }
+            std::array<std::size_t, N> shape;
+            for (std::size_t axis = 0; axis < N; ++axis) { shape[axis] = static_cast<std::size_t>(header_.shape[axis]); }
+            return owl::math::ndarray_view<const value_type, N>(reinterpret_cast<const value_type*>(file_.data() + sizeof(header)), shape);
+        }
+
+        // rows [first, last) of the array
+        template <typename value_type, std::size_t N> owl::math::ndarray_view<const value_type, N> rows(std::size_t first, std::size_t last) const {
+            if (first > last || last > rows()) { throw std::out_of_range("owl::checkpoint::reader: rows out of range"); }
+            return view<value_type, N>().slice(0, first, last);
+        }
+
+        std::uint64_t checksum(std::size_t first, std::size_t last) const {
+            if (first > last || last > rows()) { throw std::out_of_range("owl::checkpoint::reader: rows out of range"); }
+            const std::size_t row_bytes = header_.row_bytes();
+            return owl::checkpoint::checksum(first, file_.data() + sizeof(header) + first * row_bytes, last - first, row_bytes);
+        }
+
+        bool verify() const {
+            return checksum(0, rows()) == header_.checksum;
+        }
+
+    private:
+        std::string path_;
+        owl::filesystem::mapped_file file_;
+        header header_;
+    };
+
+    template <typename type, std::size_t N> inline void save(const std::string& path, owl::math::ndarray_view<const type, N> values) {
+        writer<type, N> out(path, values.shape());
+        out.append(values);
+        out.close();
+    }
+
+    template <typename type, std::size_t N> inline void save(const std::string& path, owl::math::ndarray_view<type, N> values) {
+        save(path, owl::math::ndarray_view<const type, N>(values));
+    }
+
+    template <typename type, std::size_t N> inline void save(const std::string& path, const owl::math::ndarray<type, N>& values) {
+        save(path, values.view());
+    }
+
+    template <typename type> inline void save(const std::string& path, const std::vector<type>& values) {
+        save(path, owl::math::ndarray_view<const type, 1>(values.data(), { values.size() }));
+    }
+
+    // nested vectors as built by owl::math::zeros; every row must have the same length
+    template <typename type> inline void save(const std::string& path, const std::vector<std::vector<type>>& values) {
+        const std::size_t columns = values.empty() ? 0 : values.front().size();
+        writer<type, 2> out(path, { values.size(), columns });
+        for (const auto& row : values) {
+            if (row.size() != columns) { throw std::runtime_error("owl::checkpoint::save: rows of different lengths"); }
+            out.append(row.data(), 1);
+        }
+        out.close();
+    }
+
+    // copies the whole array into memory, checking the checksum on the way
+    template <typename type, std::size_t N> inline owl::math::ndarray<type, N> load(const std::string& path) {
+        reader in(path);
+        auto view = in.view<type, N>();
+        if (!in.verify()) { throw std::runtime_error("owl::checkpoint: " + path + " checksum mismatch"); }
+        owl::math::ndarray<type, N> values(view.shape());
+        std::copy(view.data(), view.data() + view.size(), values.data());
+        return values;
+    }
+}
+
+#endif
\ No newline at end of file
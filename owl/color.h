@@ -3,35 +3,182 @@
 #ifndef OWL_COLOR_H
 #define OWL_COLOR_H
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <sstream>
+#include <utility>
+#include <vector>
+
+#include <owl/simd.h>
 
 namespace owl::color {
-    struct Color { 
-        int r, g, b; 
+    struct Color {
+        int r, g, b;
         Color(int r, int g, int b) : r(r), g(g), b(b) {}
     };
 
-    inline Color toRGB(std::string hex) {
-        int r, g, b;
-        std::sscanf(hex.c_str(), "#%02x%02x%02x", &r, &g, &b);
-        return Color(r, g, b);
+    // 0xRRGGBB
+    inline std::uint32_t pack(Color color) {
+        return (static_cast<std::uint32_t>(color.r & 0xFF) << 16) | (static_cast<std::uint32_t>(color.g & 0xFF) << 8) | static_cast<std::uint32_t>(color.b & 0xFF);
+    }
+
+    inline Color unpack(std::uint32_t rgb) {
+        return Color((rgb >> 16) & 0xFF, (rgb >> 8) & 0xFF, rgb & 0xFF);
+    }
+
+    inline int hex_digit(char c) {
+        if (c >= '0' && c <= '9') { return c - '0'; }
+        c = static_cast<char>(c | 0x20);
+        if (c >= 'a' && c <= 'f') { return c - 'a' + 10; }
+        return -1;
+    }
+
+    // parses "#rrggbb" or "rrggbb" (either case) into 0xRRGGBB; returns false and leaves rgb untouched otherwise
+    inline bool parse_hex(std::string_view hex, std::uint32_t& rgb) {
+        if (!hex.empty() && hex.front() == '#') { hex.remove_prefix(1); }
+        if (hex.size() != 6) { return false; }
+
+        std::uint32_t value = 0;
+        for (char c : hex) {
+            int digit = hex_digit(c);
+            if (digit < 0) { return false; }
+            value = (value << 4) | static_cast<std::uint32_t>(digit);
+        }
+        rgb = value;
+        return true;
+    }
+
+    // writes "#rrggbb" into out[0..7); no terminator
+    inline void format_hex(std::uint32_t rgb, char* out) {
+        constexpr char digits[] = "0123456789abcdef";
+        out[0] = '#';
+        for (int i = 6; i >= 1; --i) {
+            out[i] = digits[rgb & 0xF];
+            rgb >>= 4;
+        }
+    }
+
+    inline Color toRGB(const std::string& hex) {
+        std::uint32_t rgb = 0;
+        parse_hex(hex, rgb);
+        return unpack(rgb);
     }
 
     inline std::string toHEX(Color color) {
-        char hex_color[8];
-        std::snprintf(hex_color, sizeof hex_color, "#%02x%02x%02x", color.r, color.g, color.b);
-        return std::string(hex_color);
+        char hex_color[7];
+        format_hex(pack(color), hex_color);
+        return std::string(hex_color, sizeof hex_color);
     }
 
     inline Color interpolate(Color a, Color b, double t) {
         return Color(
-            a.r + (b.r - a.r) * t, 
-            a.g + (b.g - a.g) * t, 
+            a.r + (b.r - a.r) * t,
+            a.g + (b.g - a.g) * t,
             a.b + (b.b - a.b) * t
         );
     }
+
+    // multi-stop color ramp sampled into a lookup table of packed 0xRRGGBB entries; mapping a value costs one
+    // multiply, a clamp and a table load, so whole grids are colored without per-cell interpolation
+    class gradient {
+    public:
+        // stops as (position, "#rrggbb") with positions increasing from 0 to 1
+        gradient(const std::vector<std::pair<double, std::string>>& stops, std::size_t size = 256) {
+            if (stops.empty()) { throw std::runtime_error("owl::color::gradient: no stops"); }
+
+            std::vector<std::pair<double, Color>> parsed;
+            for (auto& [position, hex] : stops) {
+                std::uint32_t rgb;
+                if (!parse_hex(hex, rgb)) { throw std::runtime_error("owl::color::gradient: invalid color " + hex); }
+                parsed.emplace_back(position, unpack(rgb));
+            }
+            build(parsed, (std::max)(size, (std::size_t)2));
+        }
+
+        // evenly spaced stops
+        gradient(const std::vector<std::string>& stops, std::size_t size = 256) : gradient(spaced(stops), size) {}
+
+        std::size_t size() const { return table_.size(); }
+
+        const std::vector<std::uint32_t>& table() const { return table_; }
+
+        // color of t in [0, 1]; values outside are clamped and NaN maps to the first entry
+        std::uint32_t operator()(double t) const {
+            return table_[index(t)];
+        }
+
+        Color color(double t) const { return unpack((*this)(t)); }
+
+        // vectorized through owl::simd::lookup; every entry matches operator() on the same value
+        void map(const double* values, std::size_t n, std::uint32_t* out) const {
+            const double scale = static_cast<double>(table_.size() - 1);
+            owl::simd::lookup(values, n, scale, 0.5, scale, table_.data(), out);
+        }
+
+        // maps values from [lower, upper] instead of [0, 1]
+        void map(const double* values, std::size_t n, std::uint32_t* out, double lower, double upper) const {
+            const double scale = static_cast<double>(table_.size() - 1);
+            const double factor = upper > lower ? scale / (upper - lower) : 0;
+            owl::simd::lookup(values, n, factor, 0.5 - lower * factor, scale, table_.data(), out);
+        }
+
+        std::vector<std::uint32_t> map(const std::vector<double>& values) const {
+            std::vector<std::uint32_t> out(values.size());
+            map(values.data(), values.size(), out.data());
+            return out;
+        }
+
+        std::vector<std::uint32_t> map(const std::vector<double>& values, double lower, double upper) const {
+            std::vector<std::uint32_t> out(values.size());
+            map(values.data(), values.size(), out.data(), lower, upper);
+            return out;
+        }
+
+    private:
+        static std::vector<std::pair<double, std::string>> spaced(const std::vector<std::string>& stops) {
+            std::vector<std::pair<double, std::string>> result;
+            for (std::size_t i = 0; i < stops.size(); ++i) {
+                result.emplace_back(stops.size() > 1 ? static_cast<double>(i) / (stops.size() - 1) : 0, stops[i]);
+            }
+            return result;
+        }
+
+        std::size_t index(double t) const {
+            const double scale = static_cast<double>(table_.size() - 1);
+            return owl::simd::table_index(t, scale, 0.5, scale);
+        }
+
+        void build(const std::vector<std::pair<double, Color>>& stops, std::size_t size) {
+            table_.resize(size);
+            std::size_t segment = 0;
+            for (std::size_t k = 0; k < size; ++k) {
+                double t = static_cast<double>(k) / (size - 1);
+                while (segment + 1 < stops.size() && stops[segment + 1].first <= t) { ++segment; }
+
+                if (segment + 1 >= stops.size() || t <= stops[segment].first) {
+                    table_[k] = pack(stops[segment].second);
+                    continue;
+                }
+
+                auto& [p0, a] = stops[segment];
+                auto& [p1, b] = stops[segment + 1];
+                double f = (t - p0) / (p1 - p0);
+                table_[k] = pack(Color(
+                    static_cast<int>(std::lround(a.r + (b.r - a.r) * f)),
+                    static_cast<int>(std::lround(a.g + (b.g - a.g) * f)),
+                    static_cast<int>(std::lround(a.b + (b.b - a.b) * f))
+                ));
+            }
+        }
+
+        std::vector<std::uint32_t> table_;
+    };
 }
 
 #endif
\ No newline at end of file
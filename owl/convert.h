@@ -3,20 +3,192 @@
 #ifndef OWL_CONVERT_H
 #define OWL_CONVERT_H
 
+#include <cstddef>
+#include <vector>
+
 #include <owl/constant.h>
+#include <owl/ndarray.h>
 
 namespace owl::convert {
-    inline double mw_to_pu(double value) {
-        return value / 100.0;
+    // unit tags
+    struct mw {};
+    struct pu {};
+    struct degree {};
+    struct radian {};
+
+    // a double tagged with its unit: mixing units, or converting a value twice, fails to compile, and the wrapper
+    // compiles down to the bare double
+    template <typename unit> class quantity {
+    public:
+        constexpr quantity() : value_(0) {}
+        constexpr explicit quantity(double value) : value_(value) {}
+
+        constexpr double value() const { return value_; }
+
+        constexpr quantity operator-() const { return quantity(-value_); }
+        constexpr quantity operator+(quantity other) const { return quantity(value_ + other.value_); }
+        constexpr quantity operator-(quantity other) const { return quantity(value_ - other.value_); }
+        constexpr quantity operator*(double factor) const { return quantity(value_ * factor); }
+        constexpr quantity operator/(double factor) const { return quantity(value_ / factor); }
+        constexpr double operator/(quantity other) const { return value_ / other.value_; }
+
+        constexpr quantity& operator+=(quantity other) {
+            value_ += other.value_;
+            return *this;
+        }
+
+        constexpr quantity& operator-=(quantity other) {
+            value_ -= other.value_;
+            return *this;
+        }
+
+        constexpr bool operator==(quantity other) const { return value_ == other.value_; }
+        constexpr bool operator!=(quantity other) const { return value_ != other.value_; }
+        constexpr bool operator<(quantity other) const { return value_ < other.value_; }
+        constexpr bool operator<=(quantity other) const { return value_ <= other.value_; }
+        constexpr bool operator>(quantity other) const { return value_ > other.value_; }
+        constexpr bool operator>=(quantity other) const { return value_ >= other.value_; }
+
+    private:
+        double value_;
+    };
+
+    template <typename unit> constexpr quantity<unit> operator*(double factor, quantity<unit> q) {
+        return q * factor;
+    }
+
+    using megawatts = quantity<mw>;
+    using per_unit = quantity<pu>;
+    using degrees = quantity<degree>;
+    using radians = quantity<radian>;
+
+    // system power base; constexpr when built from a constant, or set at run time from case data
+    class base {
+    public:
+        constexpr explicit base(double mva = 100.0) : mva_(mva) {}
+
+        constexpr double mva() const { return mva_; }
+
+    private:
+        double mva_;
+    };
+
+    inline constexpr base default_base{ 100.0 };
+
+    constexpr double mw_to_pu(double value, double base_mva = 100.0) {
+        return value / base_mva;
     }
 
-    inline double pu_to_mw(double value) {
-        return value * 100.0;
+    constexpr double pu_to_mw(double value, double base_mva = 100.0) {
+        return value * base_mva;
     }
 
-    inline double degree_to_radian(double value) {
+    constexpr double degree_to_radian(double value) {
         return (value * owl::constant::pi) / 180;
     }
+
+    constexpr double radian_to_degree(double value) {
+        return (value * 180) / owl::constant::pi;
+    }
+
+    constexpr per_unit to_pu(megawatts value, base b = default_base) {
+        return per_unit(mw_to_pu(value.value(), b.mva()));
+    }
+
+    constexpr megawatts to_mw(per_unit value, base b = default_base) {
+        return megawatts(pu_to_mw(value.value(), b.mva()));
+    }
+
+    constexpr radians to_radian(degrees value) {
+        return radians(degree_to_radian(value.value()));
+    }
+
+    constexpr degrees to_degree(radians value) {
+        return degrees(radian_to_degree(value.value()));
+    }
+
+    // in-place bulk conversions; each element gets exactly the scalar function's result. The _inplace suffix keeps
+    // calls like mw_to_pu(0, 100) from matching the pointer overloads
+    inline void mw_to_pu_inplace(double* values, std::size_t n, double base_mva = 100.0) {
+        for (std::size_t i = 0; i < n; ++i) { values[i] = values[i] / base_mva; }
+    }
+
+    inline void pu_to_mw_inplace(double* values, std::size_t n, double base_mva = 100.0) {
+        for (std::size_t i = 0; i < n; ++i) { values[i] = values[i] * base_mva; }
+    }
+
+    inline void degree_to_radian_inplace(double* values, std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) { values[i] = (values[i] * owl::constant::pi) / 180; }
+    }
+
+    inline void radian_to_degree_inplace(double* values, std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) { values[i] = (values[i] * 180) / owl::constant::pi; }
+    }
+
+    inline void mw_to_pu_inplace(std::vector<double>& values, double base_mva = 100.0) {
+        mw_to_pu_inplace(values.data(), values.size(), base_mva);
+    }
+
+    inline void pu_to_mw_inplace(std::vector<double>& values, double base_mva = 100.0) {
+        pu_to_mw_inplace(values.data(), values.size(), base_mva);
+    }
+
+    inline void degree_to_radian_inplace(std::vector<double>& values) {
+        degree_to_radian_inplace(values.data(), values.size());
+    }
+
+    inline void radian_to_degree_inplace(std::vector<double>& values) {
+        radian_to_degree_inplace(values.data(), values.size());
+    }
+
+    template <std::size_t N> inline void mw_to_pu_inplace(owl::math::ndarray_view<double, N> values, double base_mva = 100.0) {
+        if (values.contiguous()) { return mw_to_pu_inplace(values.data(), values.size(), base_mva); }
+        values.for_each([base_mva](double& x) { x = x / base_mva; });
+    }
+
+    template <std::size_t N> inline void pu_to_mw_inplace(owl::math::ndarray_view<double, N> values, double base_mva = 100.0) {
+        if (values.contiguous()) { return pu_to_mw_inplace(values.data(), values.size(), base_mva); }
+        values.for_each([base_mva](double& x) { x = x * base_mva; });
+    }
+
+    template <std::size_t N> inline void degree_to_radian_inplace(owl::math::ndarray_view<double, N> values) {
+        if (values.contiguous()) { return degree_to_radian_inplace(values.data(), values.size()); }
+        values.for_each([](double& x) { x = (x * owl::constant::pi) / 180; });
+    }
+
+    template <std::size_t N> inline void radian_to_degree_inplace(owl::math::ndarray_view<double, N> values) {
+        if (values.contiguous()) { return radian_to_degree_inplace(values.data(), values.size()); }
+        values.for_each([](double& x) { x = (x * 180) / owl::constant::pi; });
+    }
+
+    template <std::size_t N> inline void mw_to_pu_inplace(owl::math::ndarray<double, N>& values, double base_mva = 100.0) {
+        mw_to_pu_inplace(values.data(), values.size(), base_mva);
+    }
+
+    template <std::size_t N> inline void pu_to_mw_inplace(owl::math::ndarray<double, N>& values, double base_mva = 100.0) {
+        pu_to_mw_inplace(values.data(), values.size(), base_mva);
+    }
+
+    template <std::size_t N> inline void degree_to_radian_inplace(owl::math::ndarray<double, N>& values) {
+        degree_to_radian_inplace(values.data(), values.size());
+    }
+
+    template <std::size_t N> inline void radian_to_degree_inplace(owl::math::ndarray<double, N>& values) {
+        radian_to_degree_inplace(values.data(), values.size());
+    }
+
+    // typed bulk conversions
+    inline std::vector<per_unit> to_pu(const std::vector<megawatts>& values, base b = default_base) {
+        std::vector<per_unit> out(values.size());
+        for (std::size_t i = 0; i < values.size(); ++i) { out[i] = to_pu(values[i], b); }
+        return out;
+    }
+
+    inline std::vector<megawatts> to_mw(const std::vector<per_unit>& values, base b = default_base) {
+        std::vector<megawatts> out(values.size());
+        for (std::size_t i = 0; i < values.size(); ++i) { out[i] = to_mw(values[i], b); }
+        return out;
+    }
 }
 
 #endif
\ No newline at end of file
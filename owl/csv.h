@@ -0,0 +1,131 @@
+#pragma once
+
+#ifndef OWL_CSV_H
+#define OWL_CSV_H
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <owl/filesystem.h>
+#include <owl/string.h>
+
+namespace owl::csv {
+    // calls f(line) for every non-empty line of data without its line break ("\n" or "\r\n"); blank lines, including
+    // the ones a file ending in "\r\n\r\n" leaves behind, are skipped so they never reach the rows as fallback values
+    template <typename function> inline void for_each_line(std::string_view data, function f) {
+        std::size_t start = 0, size = data.size();
+        while (start < size) {
+            std::size_t end = owl::string::find(data, '\n', start);
+            if (end == std::string_view::npos) { end = size; }
+
+            std::size_t last = end;
+            if (last > start && data[last - 1] == '\r') { --last; }
+            if (last > start) { f(data.substr(start, last - start)); }
+            start = end + 1;
+        }
+    }
+
+    // calls f(fields) for every row; fields are trimmed views into data held in one buffer reused across rows
+    template <typename function> inline void for_each_row(std::string_view data, char delimiter, function f) {
+        std::vector<std::string_view> fields;
+        for_each_line(data, [&](std::string_view line) {
+            owl::string::split_view(line, delimiter, fields);
+            f(static_cast<const std::vector<std::string_view>&>(fields));
+        });
+    }
+
+    template <typename type> inline bool parse(std::string_view s, type& value) {
+        if (!s.empty() && s.front() == '+') { s.remove_prefix(1); }
+        auto [end, error] = std::from_chars(s.data(), s.data() + s.size(), value);
+        return error == std::errc() && end == s.data() + s.size();
+    }
+
+    template <typename type> inline type to_number(std::string_view s, type fallback = 0) {
+        type value;
+        return parse(s, value) ? value : fallback;
+    }
+
+    // splits data into at most parts contiguous slices that start and end on line boundaries, so every thread or rank
+    // can parse its own slice (for example slice owl::parallel::rank() of partition(data, owl::parallel::size()))
+    inline std::vector<std::string_view> partition(std::string_view data, std::size_t parts) {
+        std::vector<std::string_view> slices;
+        std::size_t start = 0, size = data.size();
+        for (std::size_t part = 1; part <= parts && start < size; ++part) {
+            std::size_t end = size;
+            if (part < parts) {
+                end = (std::max)(start, (size * part) / parts);
+                end = owl::string::find(data, '\n', end);
+                end = end == std::string_view::npos ? size : end + 1;
+            }
+            slices.push_back(data.substr(start, end - start));
+            start = end;
+        }
+        return slices;
+    }
+
+    // parses the requested column indices of every row into columns (one vector per index), reusing their capacity;
+    // fields that are missing or not numeric become fallback. Returns the number of rows read
+    inline std::size_t read_columns(std::string_view data, char delimiter, const std::vector<std::size_t>& indices, std::vector<std::vector<double>>& columns, double fallback = 0) {
+        columns.resize(indices.size());
+        for (auto& column : columns) { column.clear(); }
+
+        std::size_t rows = 0;
+        for_each_row(data, delimiter, [&](const std::vector<std::string_view>& fields) {
+            for (std::size_t c = 0; c < indices.size(); ++c) {
+                columns[c].push_back(indices[c] < fields.size() ? to_number<double>(fields[indices[c]], fallback) : fallback);
+            }
+            ++rows;
+        });
+        return rows;
+    }
+
+    class reader {
+    public:
+        explicit reader(const std::string& path, char delimiter = ',', std::size_t header_rows = 0) : file_(path), delimiter_(delimiter) {
+            body_ = file_.view();
+            for (std::size_t row = 0; row < header_rows && !body_.empty(); ++row) {
+                std::size_t end = owl::string::find(body_, '\n');
+                std::string_view line = body_.substr(0, end);
+                if (!line.empty() && line.back() == '\r') { line.remove_suffix(1); }
+                header_.push_back(line);
+                body_.remove_prefix(end == std::string_view::npos ? body_.size() : end + 1);
+            }
+        }
+
+        char delimiter() const { return delimiter_; }
+
+        const std::vector<std::string_view>& header() const { return header_; }
+
+        std::vector<std::string_view> header_fields(std::size_t row = 0) const {
+            return owl::string::split_view(header_.at(row), delimiter_);
+        }
+
+        // every row after the header lines
+        std::string_view data() const { return body_; }
+
+        std::vector<std::string_view> partition(std::size_t parts) const {
+            return owl::csv::partition(body_, parts);
+        }
+
+        template <typename function> void for_each_row(function f) const {
+            owl::csv::for_each_row(body_, delimiter_, f);
+        }
+
+        std::size_t read_columns(const std::vector<std::size_t>& indices, std::vector<std::vector<double>>& columns, double fallback = 0) const {
+            return owl::csv::read_columns(body_, delimiter_, indices, columns, fallback);
+        }
+
+    private:
+        owl::filesystem::mapped_file file_;
+        char delimiter_;
+        std::string_view body_;
+        std::vector<std::string_view> header_;
+    };
+}
+
+#endif
\ No newline at end of file
@@ -6,12 +6,16 @@
 #include <cmath>
 #include <vector>
 #include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <numeric>
+#include <stdexcept>
 #include <utility>
 #include <limits>
 
 namespace owl::datetime {
-    inline bool is_leap_year(int year) {
+    constexpr bool is_leap_year(int year) {
         if ((year & 3) != 0) return false;
         return ((year % 100) != 0 || (year % 400) == 0);
     }
@@ -19,6 +23,206 @@ namespace owl::datetime {
     inline int year_to_decade(int year) {
         return year - (year % 10);
     }
+
+    constexpr int days_in_year(int year) {
+        return is_leap_year(year) ? 366 : 365;
+    }
+
+    constexpr int hours_in_year(int year) {
+        return days_in_year(year) * 24;
+    }
+
+    // day of the year (0-based) on which each month starts, indexed [leap][month - 1], with the year length as entry 12
+    inline constexpr std::array<std::array<int, 13>, 2> month_start_day = { {
+        { 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334, 365 },
+        { 0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335, 366 },
+    } };
+
+    constexpr int days_in_month(int year, int month) {
+        auto& starts = month_start_day[is_leap_year(year)];
+        return starts[month] - starts[month - 1];
+    }
+
+    // month (1-12) of every day of the year, indexed [leap][day of year]
+    constexpr std::array<std::array<std::uint8_t, 366>, 2> make_month_of_day() {
+        std::array<std::array<std::uint8_t, 366>, 2> table{};
+        for (int leap = 0; leap < 2; ++leap) {
+            for (int month = 1; month <= 12; ++month) {
+                for (int day = month_start_day[leap][month - 1]; day < month_start_day[leap][month]; ++day) {
+                    table[leap][day] = static_cast<std::uint8_t>(month);
+                }
+            }
+        }
+        return table;
+    }
+
+    inline constexpr std::array<std::array<std::uint8_t, 366>, 2> month_of_day = make_month_of_day();
+
+    // days since 1970-01-01 of a proleptic Gregorian date (H. Hinnant's days_from_civil)
+    constexpr long days_from_civil(int year, int month, int day) {
+        year -= month <= 2;
+        const long era = (year >= 0 ? year : year - 399) / 400;
+        const long yoe = year - era * 400;
+        const long doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        const long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + doe - 719468;
+    }
+
+    // 0 = Sunday ... 6 = Saturday
+    constexpr int day_of_week(int year, int month, int day) {
+        long days = days_from_civil(year, month, day);
+        return static_cast<int>(days >= -4 ? (days + 4) % 7 : (days + 5) % 7 + 6);
+    }
+
+    struct date_hour {
+        int year;
+        int month;
+        int day;
+        int hour;
+
+        bool operator==(const date_hour& other) const {
+            return year == other.year && month == other.month && day == other.day && hour == other.hour;
+        }
+
+        bool operator!=(const date_hour& other) const { return !(*this == other); }
+    };
+
+    // half-open range [first, second) of hour indices
+    using hour_range = std::pair<int, int>;
+
+    // Hourly horizon from January 1st of first_year, hour 0, to December 31st of last_year, hour 23. Hour indices count
+    // from 0 at the start of the horizon; conversions take constant time through per-year offsets and the constexpr
+    // day-of-year tables. Hour indices and years outside the horizon throw std::out_of_range; months and days are not checked.
+    class calendar {
+    public:
+        calendar(int first_year, int last_year) : first_year_(first_year), last_year_(last_year) {
+            if (last_year < first_year) { throw std::runtime_error("owl::datetime::calendar: last_year < first_year"); }
+
+            year_start_.push_back(0);
+            for (int year = first_year; year <= last_year; ++year) { year_start_.push_back(year_start_.back() + hours_in_year(year)); }
+        }
+
+        int first_year() const { return first_year_; }
+        int last_year() const { return last_year_; }
+        int years() const { return last_year_ - first_year_ + 1; }
+
+        // total hours in the horizon
+        int hours() const { return year_start_.back(); }
+
+        int year_start(int year) const { return year_start_[year_index(year)]; }
+
+        int to_hour(int year, int month, int day, int hour) const {
+            return year_start_[year_index(year)] + (month_start_day[is_leap_year(year)][month - 1] + day - 1) * 24 + hour;
+        }
+
+        int to_hour(const date_hour& d) const {
+            return to_hour(d.year, d.month, d.day, d.hour);
+        }
+
+        date_hour to_date(int h) const {
+            if (h < 0 || h >= hours()) { throw std::out_of_range("owl::datetime::calendar::to_date: hour outside the horizon"); }
+
+            // years are 8760 or 8784 hours long, so the estimate is at most one step off over any practical horizon
+            int index = (std::min)(h / 8766, years() - 1);
+            while (year_start_[index] > h) { --index; }
+            while (year_start_[index + 1] <= h) { ++index; }
+
+            int year = first_year_ + index;
+            int offset = h - year_start_[index];
+            int day_of_year = offset / 24;
+            bool leap = is_leap_year(year);
+            int month = month_of_day[leap][day_of_year];
+            return { year, month, day_of_year - month_start_day[leap][month - 1] + 1, offset % 24 };
+        }
+
+        // 0 = Sunday ... 6 = Saturday
+        int day_of_week(int h) const {
+            return (first_weekday_ + h / 24) % 7;
+        }
+
+        void to_date(const int* hours, std::size_t n, date_hour* out) const {
+            for (std::size_t i = 0; i < n; ++i) { out[i] = to_date(hours[i]); }
+        }
+
+        void to_hour(const date_hour* dates, std::size_t n, int* out) const {
+            for (std::size_t i = 0; i < n; ++i) { out[i] = to_hour(dates[i]); }
+        }
+
+        std::vector<date_hour> to_date(const std::vector<int>& hours) const {
+            std::vector<date_hour> out(hours.size());
+            to_date(hours.data(), hours.size(), out.data());
+            return out;
+        }
+
+        std::vector<int> to_hour(const std::vector<date_hour>& dates) const {
+            std::vector<int> out(dates.size());
+            to_hour(dates.data(), dates.size(), out.data());
+            return out;
+        }
+
+        // hour range of every month of the horizon, in order
+        std::vector<hour_range> month_ranges() const {
+            std::vector<hour_range> ranges;
+            ranges.reserve(static_cast<std::size_t>(years()) * 12);
+            for (int year = first_year_; year <= last_year_; ++year) {
+                auto& starts = month_start_day[is_leap_year(year)];
+                int start = year_start(year);
+                for (int month = 0; month < 12; ++month) { ranges.emplace_back(start + starts[month] * 24, start + starts[month + 1] * 24); }
+            }
+            return ranges;
+        }
+
+        // hour range of every week starting on first_weekday (0 = Sunday); the first and last weeks may be partial
+        std::vector<hour_range> week_ranges(int first_weekday = 1) const {
+            std::vector<hour_range> ranges;
+            int first = 0;
+            int days = (first_weekday - first_weekday_ + 7) % 7;
+            for (int last = days * 24; first < hours(); last += 7 * 24) {
+                last = (std::min)(last, hours());
+                if (last > first) { ranges.emplace_back(first, last); }
+                first = last;
+            }
+            return ranges;
+        }
+
+        std::vector<hour_range> day_ranges() const {
+            std::vector<hour_range> ranges(hours() / 24);
+            for (std::size_t day = 0; day < ranges.size(); ++day) { ranges[day] = { static_cast<int>(day) * 24, static_cast<int>(day + 1) * 24 }; }
+            return ranges;
+        }
+
+    private:
+        std::size_t year_index(int year) const {
+            if (year < first_year_ || year > last_year_) { throw std::out_of_range("owl::datetime::calendar: year outside the horizon"); }
+            return static_cast<std::size_t>(year - first_year_);
+        }
+
+        int first_year_;
+        int last_year_;
+        int first_weekday_ = owl::datetime::day_of_week(first_year_, 1, 1);
+        std::vector<int> year_start_;
+    };
+
+    // sum of hourly values over each range; ranges reaching past the end of hourly are clipped
+    inline std::vector<double> sum_by_range(const std::vector<double>& hourly, const std::vector<hour_range>& ranges) {
+        std::vector<double> result(ranges.size(), 0);
+        int size = static_cast<int>(hourly.size());
+        for (std::size_t r = 0; r < ranges.size(); ++r) {
+            int first = (std::min)(ranges[r].first, size), last = (std::min)(ranges[r].second, size);
+            result[r] = std::accumulate(hourly.begin() + first, hourly.begin() + last, 0.0);
+        }
+        return result;
+    }
+
+    inline std::vector<double> mean_by_range(const std::vector<double>& hourly, const std::vector<hour_range>& ranges) {
+        std::vector<double> result = sum_by_range(hourly, ranges);
+        int size = static_cast<int>(hourly.size());
+        for (std::size_t r = 0; r < ranges.size(); ++r) {
+            int count = (std::min)(ranges[r].second, size) - (std::min)(ranges[r].first, size);
+            result[r] = count > 0 ? result[r] / count : 0;
+        }
+        return result;
+    }
 }
 
 #endif
\ No newline at end of file
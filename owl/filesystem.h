@@ -73,7 +73,26 @@ namespace std {
 #ifndef OWL_FILESYSTEM_H
 #define OWL_FILESYSTEM_H
 
+#include <cstddef>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace owl::filesystem {
     const std::string SEPARATOR =
@@ -82,6 +101,106 @@ namespace owl::filesystem {
 #else
         "/";
 #endif
+
+    // read-only memory mapping of a whole file; the bytes are paged in on demand and never copied
+    class mapped_file {
+    public:
+        mapped_file() = default;
+
+        explicit mapped_file(const std::string& path) {
+#ifdef _WIN32
+            file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (file_ == INVALID_HANDLE_VALUE) { throw std::runtime_error("owl::filesystem::mapped_file: cannot open " + path); }
+
+            LARGE_INTEGER size;
+            GetFileSizeEx(file_, &size);
+            size_ = static_cast<std::size_t>(size.QuadPart);
+            if (size_ > 0) {
+                mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                data_ = mapping_ ? MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0) : nullptr;
+                if (data_ == nullptr) {
+                    close();
+                    throw std::runtime_error("owl::filesystem::mapped_file: cannot map " + path);
+                }
+            }
+#else
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) { throw std::runtime_error("owl::filesystem::mapped_file: cannot open " + path); }
+
+            struct stat status;
+            if (::fstat(fd, &status) != 0) {
+                ::close(fd);
+                throw std::runtime_error("owl::filesystem::mapped_file: cannot stat " + path);
+            }
+
+            size_ = static_cast<std::size_t>(status.st_size);
+            if (size_ > 0) {
+                void* data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (data == MAP_FAILED) {
+                    ::close(fd);
+                    throw std::runtime_error("owl::filesystem::mapped_file: cannot map " + path);
+                }
+                ::madvise(data, size_, MADV_SEQUENTIAL);
+                data_ = data;
+            }
+            ::close(fd);
+#endif
+        }
+
+        mapped_file(const mapped_file&) = delete;
+        mapped_file& operator=(const mapped_file&) = delete;
+
+        mapped_file(mapped_file&& other) noexcept {
+            swap(other);
+        }
+
+        mapped_file& operator=(mapped_file&& other) noexcept {
+            if (this != &other) {
+                close();
+                swap(other);
+            }
+            return *this;
+        }
+
+        ~mapped_file() {
+            close();
+        }
+
+        const char* data() const { return static_cast<const char*>(data_); }
+        std::size_t size() const { return size_; }
+        std::string_view view() const { return std::string_view(data(), size_); }
+
+        void close() {
+#ifdef _WIN32
+            if (data_ != nullptr) { UnmapViewOfFile(data_); }
+            if (mapping_ != nullptr) { CloseHandle(mapping_); }
+            if (file_ != INVALID_HANDLE_VALUE) { CloseHandle(file_); }
+            mapping_ = nullptr;
+            file_ = INVALID_HANDLE_VALUE;
+#else
+            if (data_ != nullptr) { ::munmap(data_, size_); }
+#endif
+            data_ = nullptr;
+            size_ = 0;
+        }
+
+    private:
+        void swap(mapped_file& other) noexcept {
+            std::swap(data_, other.data_);
+            std::swap(size_, other.size_);
+#ifdef _WIN32
+            std::swap(file_, other.file_);
+            std::swap(mapping_, other.mapping_);
+#endif
+        }
+
+        void* data_ = nullptr;
+        std::size_t size_ = 0;
+#ifdef _WIN32
+        HANDLE file_ = INVALID_HANDLE_VALUE;
+        HANDLE mapping_ = nullptr;
+#endif
+    };
 }
 
 #endif
\ No newline at end of file
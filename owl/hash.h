@@ -3,34 +3,347 @@
 #ifndef OWL_HASH_H
 #define OWL_HASH_H
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <stdexcept>
 #include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
 
+namespace owl::hash {
+    // 64-bit finalizer from boost::hash_combine (1.81+); spreads every input bit over the whole word
+    inline std::size_t mix(std::size_t value) {
+        std::uint64_t x = value;
+        const std::uint64_t m = 0xe9846af9b1a615d;
+        x ^= x >> 32;
+        x *= m;
+        x ^= x >> 32;
+        x *= m;
+        x ^= x >> 28;
+        return static_cast<std::size_t>(x);
+    }
+
+    // order-dependent: combine(combine(0, a), b) != combine(combine(0, b), a), and equal parts do not cancel out
+    inline std::size_t combine(std::size_t seed, std::size_t value) {
+        return mix(seed + 0x9e3779b9 + value);
+    }
+
+    // 64-bit hash of a byte range: four independent lanes take 32 bytes per step, so large buffers hash at memory speed.
+    // Fast and well spread, but not meant for untrusted input
+    inline std::uint64_t bytes(const void* data, std::size_t size, std::uint64_t seed = 0) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        const std::uint64_t p1 = 0x9e3779b185ebca87, p2 = 0xc2b2ae3d27d4eb4f;
+        std::uint64_t lanes[4] = { seed + p1 + p2, seed + p2, seed, seed - p1 };
+
+        std::size_t i = 0;
+        for (; i + 32 <= size; i += 32) {
+            for (int lane = 0; lane < 4; ++lane) {
+                std::uint64_t word;
+                std::memcpy(&word, p + i + 8 * lane, 8);
+                std::uint64_t x = lanes[lane] + word * p2;
+                lanes[lane] = ((x << 31) | (x >> 33)) * p1;
+            }
+        }
+
+        std::uint64_t h = size;
+        for (auto lane : lanes) { h = combine(h, lane); }
+        for (; i + 8 <= size; i += 8) {
+            std::uint64_t word;
+            std::memcpy(&word, p + i, 8);
+            h = combine(h, word);
+        }
+        if (i < size) {
+            std::uint64_t word = 0;
+            std::memcpy(&word, p + i, size - i);
+            h = combine(h, word);
+        }
+        return h;
+    }
+
+    // hashes pairs, tuples and anything std::hash covers, mixing the parts with combine; use it as the hasher of
+    // std::unordered_map or std::unordered_set for composite keys, e.g. std::unordered_map<key, double, tuple_hash>
+    struct tuple_hash {
+        template <typename first_type, typename second_type> std::size_t operator()(const std::pair<first_type, second_type>& v) const {
+            return combine(combine(0, (*this)(v.first)), (*this)(v.second));
+        }
+
+        template <typename... types> std::size_t operator()(const std::tuple<types...>& v) const {
+            return std::apply([this](const auto&... parts) {
+                std::size_t seed = 0;
+                ((seed = combine(seed, (*this)(parts))), ...);
+                return seed;
+            }, v);
+        }
+
+        template <typename type> std::size_t operator()(const type& v) const {
+            return std::hash<type>{}(v);
+        }
+    };
+
+    template <typename... types> inline std::size_t values(const types&... v) {
+        std::size_t seed = 0;
+        ((seed = combine(seed, tuple_hash{}(v))), ...);
+        return seed;
+    }
+
+    // open-addressing hash map with linear probing and backward-shift deletion, tuned for small trivially copyable keys
+    // such as (bus, block, scenario) tuples: one contiguous slot array, no per-element allocation. Keys are const through
+    // iterators, as in std::unordered_map; value must be default constructible. Iterators and references are
+    // invalidated by any insertion that grows the table
+    template <typename key, typename value, typename hasher = tuple_hash> class flat_map {
+    public:
+        using value_type = std::pair<const key, value>;
+
+        template <typename map_type, typename pair_type> class basic_iterator {
+        public:
+            basic_iterator(map_type* map, std::size_t index) : map_(map), index_(index) { skip(); }
+
+            pair_type& operator*() const { return map_->slots_[index_].pair; }
+            pair_type* operator->() const { return &map_->slots_[index_].pair; }
+
+            basic_iterator& operator++() {
+                ++index_;
+                skip();
+                return *this;
+            }
+
+            bool operator==(const basic_iterator& other) const { return index_ == other.index_; }
+            bool operator!=(const basic_iterator& other) const { return index_ != other.index_; }
+
+        private:
+            void skip() {
+                while (index_ < map_->used_.size() && !map_->used_[index_]) { ++index_; }
+            }
+
+            map_type* map_;
+            std::size_t index_;
+        };
+
+        using iterator = basic_iterator<flat_map, value_type>;
+        using const_iterator = basic_iterator<const flat_map, const value_type>;
+
+        flat_map() = default;
+
+        explicit flat_map(std::size_t capacity) {
+            reserve(capacity);
+        }
+
+        flat_map(const flat_map& other) : slots_(new slot[other.used_.size()]), used_(other.used_.size(), 0) {
+            for (std::size_t i = 0; i < other.used_.size(); ++i) {
+                if (other.used_[i]) { construct(i, other.slots_[i].pair); }
+            }
+            size_ = other.size_;
+        }
+
+        flat_map(flat_map&& other) noexcept {
+            swap(other);
+        }
+
+        flat_map& operator=(const flat_map& other) {
+            if (this != &other) {
+                flat_map copy(other);
+                swap(copy);
+            }
+            return *this;
+        }
+
+        flat_map& operator=(flat_map&& other) noexcept {
+            swap(other);
+            return *this;
+        }
+
+        ~flat_map() {
+            clear();
+        }
+
+        void swap(flat_map& other) noexcept {
+            std::swap(slots_, other.slots_);
+            std::swap(used_, other.used_);
+            std::swap(size_, other.size_);
+        }
+
+        std::size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+
+        iterator begin() { return iterator(this, 0); }
+        iterator end() { return iterator(this, used_.size()); }
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, used_.size()); }
+
+        void clear() {
+            for (std::size_t i = 0; i < used_.size(); ++i) {
+                if (used_[i]) { destroy(i); }
+            }
+            size_ = 0;
+        }
+
+        // makes room for n elements without rehashing
+        void reserve(std::size_t n) {
+            std::size_t capacity = 16;
+            while (capacity * 3 < n * 4) { capacity *= 2; }
+            if (capacity > used_.size()) { rehash(capacity); }
+        }
+
+        iterator find(const key& k) {
+            return iterator(this, locate(k));
+        }
+
+        const_iterator find(const key& k) const {
+            return const_iterator(this, locate(k));
+        }
+
+        bool contains(const key& k) const { return locate(k) != used_.size(); }
+        std::size_t count(const key& k) const { return contains(k) ? 1 : 0; }
+
+        value& at(const key& k) {
+            auto index = locate(k);
+            if (index == used_.size()) { throw std::out_of_range("owl::hash::flat_map::at"); }
+            return slots_[index].pair.second;
+        }
+
+        const value& at(const key& k) const {
+            auto index = locate(k);
+            if (index == used_.size()) { throw std::out_of_range("owl::hash::flat_map::at"); }
+            return slots_[index].pair.second;
+        }
+
+        std::pair<iterator, bool> insert(const key& k, const value& v) {
+            auto [index, inserted] = slot_of(k);
+            if (inserted) { slots_[index].pair.second = v; }
+            return std::make_pair(iterator(this, index), inserted);
+        }
+
+        std::pair<iterator, bool> insert(const value_type& p) {
+            return insert(p.first, p.second);
+        }
+
+        value& operator[](const key& k) {
+            return slots_[slot_of(k).first].pair.second;
+        }
+
+        std::size_t erase(const key& k) {
+            auto index = locate(k);
+            if (index == used_.size()) { return 0; }
+
+            // backward-shift deletion keeps every probe sequence contiguous, so no tombstones are needed
+            std::size_t mask = used_.size() - 1;
+            std::size_t hole = index;
+            destroy(hole);
+            for (std::size_t next = (hole + 1) & mask; used_[next]; next = (next + 1) & mask) {
+                std::size_t home = bucket(slots_[next].pair.first);
+                if (((next - home) & mask) >= ((next - hole) & mask)) {
+                    construct(hole, std::move(slots_[next].pair));
+                    destroy(next);
+                    hole = next;
+                }
+            }
+            --size_;
+            return 1;
+        }
+
+    private:
+        // raw storage for one element: the key is const, so elements are constructed in place and destroyed, never
+        // assigned; used_ says which slots hold one
+        union slot {
+            slot() {}
+            ~slot() {}
+            value_type pair;
+        };
+
+        template <typename... args> void construct(std::size_t index, args&&... a) {
+            new (&slots_[index].pair) value_type(std::forward<args>(a)...);
+            used_[index] = 1;
+        }
+
+        void destroy(std::size_t index) {
+            slots_[index].pair.~value_type();
+            used_[index] = 0;
+        }
+
+        std::size_t bucket(const key& k) const {
+            return mix(hasher{}(k)) & (used_.size() - 1);
+        }
+
+        // index of k, or used_.size() when absent
+        std::size_t locate(const key& k) const {
+            if (size_ == 0) { return used_.size(); }
+
+            std::size_t mask = used_.size() - 1;
+            for (std::size_t index = bucket(k); used_[index]; index = (index + 1) & mask) {
+                if (slots_[index].pair.first == k) { return index; }
+            }
+            return used_.size();
+        }
+
+        // index of k, inserting a default value first when absent
+        std::pair<std::size_t, bool> slot_of(const key& k) {
+            auto found = locate(k);
+            if (found != used_.size()) { return std::make_pair(found, false); }
+
+            if ((size_ + 1) * 4 > used_.size() * 3) { rehash((std::max)(used_.size() * 2, (std::size_t)16)); }
+
+            std::size_t mask = used_.size() - 1;
+            std::size_t index = bucket(k);
+            while (used_[index]) { index = (index + 1) & mask; }
+
+            construct(index, std::piecewise_construct, std::forward_as_tuple(k), std::forward_as_tuple());
+            ++size_;
+            return std::make_pair(index, true);
+        }
+
+        void rehash(std::size_t capacity) {
+            std::unique_ptr<slot[]> slots(new slot[capacity]);
+            std::vector<std::uint8_t> used(capacity, 0);
+            std::swap(slots, slots_);
+            std::swap(used, used_);
+
+            std::size_t mask = capacity - 1;
+            for (std::size_t i = 0; i < used.size(); ++i) {
+                if (!used[i]) { continue; }
+
+                std::size_t index = bucket(slots[i].pair.first);
+                while (used_[index]) { index = (index + 1) & mask; }
+                construct(index, std::move(slots[i].pair));
+                slots[i].pair.~value_type();
+            }
+        }
+
+        std::unique_ptr<slot[]> slots_;
+        std::vector<std::uint8_t> used_;
+        std::size_t size_ = 0;
+    };
+}
+
+// the composite keys the library has always hashed through std::hash; other pair and tuple keys take
+// owl::hash::tuple_hash explicitly
 namespace std {
     template <> struct hash<std::pair<std::string, std::string>> {
         inline size_t operator()(const std::pair<std::string, std::string>& v) const {
-            std::hash<std::string> string_hasher;
-            return string_hasher(v.first) ^ string_hasher(v.second);
+            return owl::hash::tuple_hash{}(v);
         }
     };
 
     template <> struct hash<std::pair<int, int>> {
         inline size_t operator()(const std::pair<int, int>& v) const {
-            std::hash<int> int_hasher;
-            return int_hasher(v.first) ^ int_hasher(v.second);
+            return owl::hash::tuple_hash{}(v);
         }
     };
 
     template <> struct hash<std::tuple<int, int>> {
         inline size_t operator()(const std::tuple<int, int>& v) const {
-            std::hash<int> int_hasher;
-            return int_hasher(std::get<0>(v)) ^ int_hasher(std::get<1>(v));
+            return owl::hash::tuple_hash{}(v);
         }
     };
 
     template <> struct hash<std::tuple<int, int, int>> {
         inline size_t operator()(const std::tuple<int, int, int>& v) const {
-            std::hash<int> int_hasher;
-            return int_hasher(std::get<0>(v)) ^ int_hasher(std::get<1>(v)) ^ int_hasher(std::get<2>(v));
+            return owl::hash::tuple_hash{}(v);
         }
     };
 }
@@ -0,0 +1,365 @@
+#pragma once
+
+#ifndef OWL_INSTRUMENT_H
+#define OWL_INSTRUMENT_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// defining OWL_DISABLE_INSTRUMENTATION turns OWL_SCOPED_TIMER, OWL_COUNT and OWL_OBSERVE into no-ops
+#ifdef OWL_DISABLE_INSTRUMENTATION
+#define OWL_SCOPED_TIMER(name) ((void)0)
+#define OWL_COUNT(name, value) ((void)0)
+#define OWL_OBSERVE(name, value) ((void)0)
+#else
+#define OWL_INSTRUMENT_CONCAT_(a, b) a##b
+#define OWL_INSTRUMENT_CONCAT(a, b) OWL_INSTRUMENT_CONCAT_(a, b)
+#define OWL_SCOPED_TIMER(name)                                                                                       \
+    static const std::size_t OWL_INSTRUMENT_CONCAT(owl_region_, __LINE__) = owl::instrument::region_id(name);       \
+    owl::instrument::scoped_timer OWL_INSTRUMENT_CONCAT(owl_timer_, __LINE__)(OWL_INSTRUMENT_CONCAT(owl_region_, __LINE__))
+#define OWL_COUNT(name, value)                                                                                       \
+    do {                                                                                                             \
+        static const std::size_t owl_counter_ = owl::instrument::counter_id(name);                                   \
+        owl::instrument::count(owl_counter_, value);                                                                 \
+    } while (0)
+#define OWL_OBSERVE(name, value)                                                                                     \
+    do {                                                                                                             \
+        static const std::size_t owl_histogram_ = owl::instrument::histogram_id(name);                               \
+        owl::instrument::observe(owl_histogram_, value);                                                             \
+    } while (0)
+#endif
+
+namespace owl::instrument {
+    using clock = std::chrono::steady_clock;
+
+    // bucket 0 holds values below 1, bucket k values in [2^(k-1), 2^k), the last one everything above
+    inline constexpr std::size_t histogram_buckets = 64;
+
+    struct region {
+        std::string name;
+        std::uint64_t calls = 0;
+        double total = 0;
+        double minimum = std::numeric_limits<double>::infinity();
+        double maximum = 0;
+
+        double mean() const { return calls > 0 ? total / calls : 0; }
+    };
+
+    struct counter {
+        std::string name;
+        double value = 0;
+    };
+
+    struct histogram {
+        std::string name;
+        std::uint64_t count = 0;
+        double sum = 0;
+        double minimum = std::numeric_limits<double>::infinity();
+        double maximum = -std::numeric_limits<double>::infinity();
+        std::array<std::uint64_t, histogram_buckets> buckets{};
+
+        // upper edge of the bucket that holds the q-th fraction of the observations
+        double quantile(double q) const {
+            std::uint64_t target = static_cast<std::uint64_t>(std::ceil(q * count));
+            std::uint64_t seen = 0;
+            for (std::size_t k = 0; k < histogram_buckets; ++k) {
+                seen += buckets[k];
+                if (seen >= target && seen > 0) { return (std::min)(std::ldexp(1.0, static_cast<int>(k)), maximum); }
+            }
+            return maximum;
+        }
+    };
+
+    // one complete timer span, in microseconds since the registry was created or last reset
+    struct event {
+        std::size_t region;
+        std::uint32_t thread;
+        double start;
+        double duration;
+    };
+
+    // regions, counters and histograms merged over every thread, indexed by their ids
+    struct snapshot {
+        std::vector<region> regions;
+        std::vector<counter> counters;
+        std::vector<histogram> histograms;
+        std::vector<event> events;
+    };
+
+    // Recording only touches the calling thread's storage, without locks; names take the lock once per call site.
+    // collect() and reset() walk every thread's storage, so call them while no other thread is recording (for example
+    // after the parallel section has joined).
+    class registry {
+    public:
+        struct storage {
+            std::uint32_t thread;
+            std::vector<region> regions;
+            std::vector<double> counters;
+            std::vector<histogram> histograms;
+            std::vector<event> events;
+        };
+
+        static registry& instance() {
+            static registry r;
+            return r;
+        }
+
+        std::size_t region_id(const std::string& name) { return id(regions_, name); }
+        std::size_t counter_id(const std::string& name) { return id(counters_, name); }
+        std::size_t histogram_id(const std::string& name) { return id(histograms_, name); }
+
+        // the calling thread's storage, created on first use and kept after the thread exits
+        storage& local() {
+            thread_local storage* s = nullptr;
+            if (s == nullptr) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                storages_.push_back(std::make_unique<storage>());
+                s = storages_.back().get();
+                s->thread = static_cast<std::uint32_t>(storages_.size() - 1);
+            }
+            return *s;
+        }
+
+        clock::time_point epoch() const { return epoch_; }
+
+        bool tracing() const { return tracing_.load(std::memory_order_relaxed); }
+
+        std::size_t trace_capacity() const { return trace_capacity_; }
+
+        // records every timer span (up to capacity per thread) for write_trace
+        void trace(bool enabled, std::size_t capacity = 1 << 20) {
+            trace_capacity_ = capacity;
+            tracing_.store(enabled, std::memory_order_relaxed);
+        }
+
+        snapshot collect() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            snapshot s;
+            s.regions.resize(regions_.names.size());
+            s.counters.resize(counters_.names.size());
+            s.histograms.resize(histograms_.names.size());
+            for (std::size_t i = 0; i < s.regions.size(); ++i) { s.regions[i].name = regions_.names[i]; }
+            for (std::size_t i = 0; i < s.counters.size(); ++i) { s.counters[i].name = counters_.names[i]; }
+            for (std::size_t i = 0; i < s.histograms.size(); ++i) { s.histograms[i].name = histograms_.names[i]; }
+
+            for (auto& t : storages_) {
+                for (std::size_t i = 0; i < t->regions.size(); ++i) {
+                    auto& a = s.regions[i];
+                    auto& b = t->regions[i];
+                    a.calls += b.calls;
+                    a.total += b.total;
+                    a.minimum = (std::min)(a.minimum, b.minimum);
+                    a.maximum = (std::max)(a.maximum, b.maximum);
+                }
+                for (std::size_t i = 0; i < t->counters.size(); ++i) { s.counters[i].value += t->counters[i]; }
+                for (std::size_t i = 0; i < t->histograms.size(); ++i) {
+                    auto& a = s.histograms[i];
+                    auto& b = t->histograms[i];
+                    a.count += b.count;
+                    a.sum += b.sum;
+                    a.minimum = (std::min)(a.minimum, b.minimum);
+                    a.maximum = (std::max)(a.maximum, b.maximum);
+                    for (std::size_t k = 0; k < histogram_buckets; ++k) { a.buckets[k] += b.buckets[k]; }
+                }
+                s.events.insert(s.events.end(), t->events.begin(), t->events.end());
+            }
+
+            std::sort(s.events.begin(), s.events.end(), [](const event& a, const event& b) { return a.start < b.start; });
+            return s;
+        }
+
+        void reset() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto& t : storages_) {
+                t->regions.clear();
+                t->counters.clear();
+                t->histograms.clear();
+                t->events.clear();
+            }
+            epoch_ = clock::now();
+        }
+
+    private:
+        struct names {
+            std::vector<std::string> names;
+            std::unordered_map<std::string, std::size_t> ids;
+        };
+
+        registry() : epoch_(clock::now()) {}
+
+        std::size_t id(names& n, const std::string& name) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto [it, inserted] = n.ids.emplace(name, n.names.size());
+            if (inserted) { n.names.push_back(name); }
+            return it->second;
+        }
+
+        std::mutex mutex_;
+        names regions_;
+        names counters_;
+        names histograms_;
+        std::vector<std::unique_ptr<storage>> storages_;
+        clock::time_point epoch_;
+        std::atomic<bool> tracing_{ false };
+        std::size_t trace_capacity_ = 1 << 20;
+    };
+
+    inline std::size_t region_id(const std::string& name) { return registry::instance().region_id(name); }
+    inline std::size_t counter_id(const std::string& name) { return registry::instance().counter_id(name); }
+    inline std::size_t histogram_id(const std::string& name) { return registry::instance().histogram_id(name); }
+
+    inline void trace(bool enabled, std::size_t capacity = 1 << 20) { registry::instance().trace(enabled, capacity); }
+
+    inline snapshot collect() { return registry::instance().collect(); }
+
+    inline void reset() { registry::instance().reset(); }
+
+    inline void record(std::size_t id, clock::time_point start, clock::time_point stop) {
+        auto& r = registry::instance();
+        auto& s = r.local();
+        if (id >= s.regions.size()) { s.regions.resize(id + 1); }
+
+        double seconds = std::chrono::duration<double>(stop - start).count();
+        auto& g = s.regions[id];
+        ++g.calls;
+        g.total += seconds;
+        g.minimum = (std::min)(g.minimum, seconds);
+        g.maximum = (std::max)(g.maximum, seconds);
+
+        if (r.tracing() && s.events.size() < r.trace_capacity()) {
+            double begin = std::chrono::duration<double, std::micro>(start - r.epoch()).count();
+            s.events.push_back({ id, s.thread, begin, seconds * 1e6 });
+        }
+    }
+
+    inline void count(std::size_t id, double value = 1) {
+        auto& s = registry::instance().local();
+        if (id >= s.counters.size()) { s.counters.resize(id + 1, 0); }
+        s.counters[id] += value;
+    }
+
+    inline void observe(std::size_t id, double value) {
+        auto& s = registry::instance().local();
+        if (id >= s.histograms.size()) { s.histograms.resize(id + 1); }
+
+        auto& h = s.histograms[id];
+        ++h.count;
+        h.sum += value;
+        h.minimum = (std::min)(h.minimum, value);
+        h.maximum = (std::max)(h.maximum, value);
+
+        int exponent = 0;
+        if (value >= 1) { std::frexp(value, &exponent); }
+        ++h.buckets[(std::min)(static_cast<std::size_t>(exponent), histogram_buckets - 1)];
+    }
+
+    // times the enclosing scope into region id
+    class scoped_timer {
+    public:
+        explicit scoped_timer(std::size_t id) : id_(id), start_(clock::now()) {}
+
+        explicit scoped_timer(const std::string& name) : scoped_timer(region_id(name)) {}
+
+        scoped_timer(const scoped_timer&) = delete;
+        scoped_timer& operator=(const scoped_timer&) = delete;
+
+        ~scoped_timer() { record(id_, start_, clock::now()); }
+
+    private:
+        std::size_t id_;
+        clock::time_point start_;
+    };
+
+    inline void write_text(std::ostream& out, const snapshot& s) {
+        char line[256];
+        if (!s.regions.empty()) {
+            std::snprintf(line, sizeof line, "%-32s %12s %14s %14s %14s %14s\n", "region", "calls", "total [s]", "mean [s]", "min [s]", "max [s]");
+            out << line;
+            for (auto& r : s.regions) {
+                if (r.calls == 0) { continue; }
+                std::snprintf(line, sizeof line, "%-32s %12llu %14.6f %14.9f %14.9f %14.9f\n", r.name.c_str(), static_cast<unsigned long long>(r.calls), r.total, r.mean(), r.minimum, r.maximum);
+                out << line;
+            }
+        }
+        if (!s.counters.empty()) {
+            std::snprintf(line, sizeof line, "%-32s %14s\n", "counter", "value");
+            out << line;
+            for (auto& c : s.counters) {
+                std::snprintf(line, sizeof line, "%-32s %14.6g\n", c.name.c_str(), c.value);
+                out << line;
+            }
+        }
+        if (!s.histograms.empty()) {
+            std::snprintf(line, sizeof line, "%-32s %12s %14s %14s %14s %14s\n", "histogram", "count", "mean", "min", "p50", "max");
+            out << line;
+            for (auto& h : s.histograms) {
+                if (h.count == 0) { continue; }
+                std::snprintf(line, sizeof line, "%-32s %12llu %14.6g %14.6g %14.6g %14.6g\n", h.name.c_str(), static_cast<unsigned long long>(h.count), h.sum / h.count, h.minimum, h.quantile(0.5), h.maximum);
+                out << line;
+            }
+        }
+    }
+
+    // s as the body of a JSON string: quotes, backslashes and control characters escaped
+    inline std::string json_escape(const std::string& s) {
+        std::string out;
+        out.reserve(s.size());
+        for (char c : s) {
+            switch (c) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        char code[8];
+                        std::snprintf(code, sizeof code, "\\u%04x", static_cast<unsigned>(c));
+                        out += code;
+                    } else {
+                        out += c;
+                    }
+            }
+        }
+        return out;
+    }
+
+    // Chrome trace event format (chrome://tracing, Perfetto); process tells ranks apart when several traces are merged
+    inline void write_trace(std::ostream& out, const snapshot& s, int process = 0) {
+        char line[128];
+        std::vector<std::string> names;
+        names.reserve(s.regions.size());
+        for (auto& r : s.regions) { names.push_back(json_escape(r.name)); }
+
+        out << "{\"traceEvents\": [\n";
+        for (std::size_t i = 0; i < s.events.size(); ++i) {
+            auto& e = s.events[i];
+            std::snprintf(line, sizeof line, "\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": %d, \"tid\": %u}%s\n",
+                e.start, e.duration, process, e.thread, i + 1 < s.events.size() ? "," : "");
+            out << "  {\"name\": \"" << names[e.region] << line;
+        }
+        out << "],\n\"displayTimeUnit\": \"ms\",\n\"otherData\": {";
+        for (std::size_t i = 0; i < s.counters.size(); ++i) {
+            // JSON has no inf or nan
+            double value = s.counters[i].value;
+            if (std::isfinite(value)) { std::snprintf(line, sizeof line, "%.17g", value); } else { std::snprintf(line, sizeof line, "null"); }
+            out << (i > 0 ? ", " : "") << "\"" << json_escape(s.counters[i].name) << "\": " << line;
+        }
+        out << "}}\n";
+    }
+}
+
+#endif
\ No newline at end of file
@@ -9,6 +9,12 @@
 #include <numeric>
 #include <utility>
 #include <limits>
+#include <memory_resource>
+#include <stdexcept>
+
+#include <owl/algorithm.h>
+#include <owl/ndarray.h>
+#include <owl/simd.h>
 
 namespace owl::math {
     inline int mod(int a, int base) {
@@ -47,6 +53,18 @@ namespace owl::math {
         return std::vector<std::vector<std::vector<std::vector<type>>>>(d1, std::vector<std::vector<std::vector<type>>>(d2, std::vector<std::vector<type>>(d3, std::vector<type>(d4, 1))));
     }
 
+    template <typename type, std::size_t N> inline ndarray<type, N> zeros(const std::array<std::size_t, N>& shape) {
+        return ndarray<type, N>(shape, 0);
+    }
+
+    template <typename type, std::size_t N> inline ndarray<type, N> ones(const std::array<std::size_t, N>& shape) {
+        return ndarray<type, N>(shape, 1);
+    }
+
+    template <typename type, std::size_t N> inline ndarray<type, N> full(const std::array<std::size_t, N>& shape, type value) {
+        return ndarray<type, N>(shape, value);
+    }
+
     template <typename type> inline std::vector<type> collect(int from, int to) {
         std::vector<type> v(to - from + 1);
         std::iota(v.begin(), v.end(), from);
@@ -66,6 +84,20 @@ namespace owl::math {
         return a == b || (std::isfinite(a) && std::isfinite(b) && std::abs(a - b) <= std::max(atol, rtol * std::max(std::abs(a), std::abs(b))));
     }
 
+    // element-wise approximately_equal of a[0, n) and b[0, n) into out, resized to n; reuse out across iterations to
+    // keep convergence checks allocation-free
+    inline void approximately_equal(const double* a, const double* b, std::size_t n, owl::algorithm::bitmask& out, double rtol = 1e-4, double atol = 0) {
+        out.resize(n);
+        owl::simd::approximately_equal(a, b, n, rtol, atol, out.data());
+    }
+
+    // a and b must have the same size
+    inline owl::algorithm::bitmask approximately_equal(const std::vector<double>& a, const std::vector<double>& b, double rtol = 1e-4, double atol = 0) {
+        owl::algorithm::bitmask out;
+        approximately_equal(a.data(), b.data(), a.size(), out, rtol, atol);
+        return out;
+    }
+
     inline bool essentially_equal(double a, double b, double rtol = 1e-4, double atol = 0) {
         //return std::abs(a - b) <= (epsilon * std::min(std::abs(a), std::abs(b)));
         return a == b || (std::isfinite(a) && std::isfinite(b) && std::abs(a - b) <= std::max(atol, rtol * std::min(std::abs(a), std::abs(b))));
@@ -85,11 +117,18 @@ namespace owl::math {
         return pairs;
     }
 
-    inline int nth_element(std::vector<double>& v, double alpha) {
+    inline std::pmr::vector<std::pair<double, int>> vector_with_indices(std::vector<double>& v, std::pmr::memory_resource* resource) {
+        std::pmr::vector<std::pair<double, int>> pairs(resource);
+        pairs.reserve(v.size());
+        for (std::size_t i = 0, size = v.size(); i < size; ++i) { pairs.push_back(std::make_pair(v[i], i)); }
+        return pairs;
+    }
+
+    inline int nth_element(std::vector<double>& v, double alpha, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
         auto size = v.size();
         if (size == 1) { return 0; }
 
-        auto pairs = owl::math::vector_with_indices(v);
+        auto pairs = owl::math::vector_with_indices(v, resource);
         auto shift = (std::min)((std::size_t)std::floor((alpha * size) / 100), size - 1);
 
         auto nth = pairs.begin() + shift;
@@ -97,40 +136,189 @@ namespace owl::math {
         return (*nth).second;
     }
 
-    inline double quantile(std::vector<double>& v, double alpha) {
-        if (v.size() == 0) return 0;
+    struct risk_measure {
+        double alpha;
+        double quantile;
+        double cvar_left;
+        double cvar_right;
+    };
 
-        auto nth = owl::math::nth_element(v, alpha);
-        return v[nth];
+    inline std::size_t quantile_position(std::size_t size, double alpha) {
+        return (std::min)((std::size_t)std::floor((alpha * size) / 100), size - 1);
     }
 
-    inline double cvar(std::vector<double>& v, double alpha, bool left = true) {
-        auto size = v.size();
+    inline std::size_t tail_size(std::size_t size, double alpha) {
+        return (std::min)((std::max)((std::size_t)std::ceil((alpha * size) / 100), (std::size_t)1), size);
+    }
+
+    // places the elements at every (sorted, unique) position in [positions_first, positions_last) as std::nth_element
+    // would, leaving v partitioned around each of them; costs O(n log k) for k positions instead of a full sort
+    inline void multi_select(double* v, std::size_t first, std::size_t last, const std::size_t* positions_first, const std::size_t* positions_last) {
+        if (positions_first == positions_last || last - first < 2) { return; }
+
+        auto middle = positions_first + (positions_last - positions_first) / 2;
+        std::nth_element(v + first, v + *middle, v + last);
+
+        multi_select(v, first, *middle, positions_first, middle);
+        multi_select(v, *middle + 1, last, middle + 1, positions_last);
+    }
+
+    // scratch buffers come from resource, so an owl::memory::arena can absorb them
+    inline std::vector<risk_measure> risk_measures(const std::vector<double>& v, const std::vector<double>& alphas, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+        std::vector<risk_measure> measures;
+        measures.reserve(alphas.size());
 
-        auto pairs = owl::math::vector_with_indices(v);
-        auto shift = (std::max)((std::size_t)std::ceil((alpha * size) / 100), (std::size_t)1);
+        auto size = v.size();
+        if (size == 0) {
+            for (auto alpha : alphas) { measures.push_back({ alpha, 0, 0, 0 }); }
+            return measures;
+        }
 
-        if (left) {
-            std::sort(std::begin(pairs), std::end(pairs));
-        } else {
-            std::sort(std::begin(pairs), std::end(pairs), std::greater<std::pair<double, int>>());
+        // the quantile positions must hold their order statistic; the tail boundaries only need the array partitioned around them
+        std::pmr::vector<std::size_t> positions(resource);
+        std::pmr::vector<std::size_t> boundaries({ 0, size }, resource);
+        for (auto alpha : alphas) {
+            auto tail = owl::math::tail_size(size, alpha);
+            positions.push_back(owl::math::quantile_position(size, alpha));
+            boundaries.push_back(tail);
+            boundaries.push_back(size - tail);
+        }
+        std::sort(boundaries.begin(), boundaries.end());
+        boundaries.erase(std::unique(boundaries.begin(), boundaries.end()), boundaries.end());
+        for (auto boundary : boundaries) {
+            if (boundary > 0 && boundary < size) { positions.push_back(boundary); }
         }
+        std::sort(positions.begin(), positions.end());
+        positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+
+        std::pmr::vector<double> values(v.begin(), v.end(), resource);
+        owl::math::multi_select(values.data(), 0, size, positions.data(), positions.data() + positions.size());
 
-        double sum = 0;
-        for (std::size_t i = 0; i < shift; ++i) {
-            sum += pairs[i].first;
+        // prefix[j] holds the sum of the boundaries[j] smallest values
+        std::pmr::vector<double> prefix(boundaries.size(), 0.0, resource);
+        for (std::size_t j = 1; j < boundaries.size(); ++j) {
+            prefix[j] = prefix[j - 1] + std::accumulate(values.begin() + boundaries[j - 1], values.begin() + boundaries[j], 0.0);
         }
-        return sum / shift;
+        auto prefix_sum = [&](std::size_t boundary) {
+            return prefix[std::lower_bound(boundaries.begin(), boundaries.end(), boundary) - boundaries.begin()];
+        };
+        auto suffix_sum = [&](std::size_t boundary) {
+            return prefix.back() - prefix_sum(boundary);
+        };
+
+        for (auto alpha : alphas) {
+            auto tail = owl::math::tail_size(size, alpha);
+            measures.push_back({
+                alpha,
+                values[owl::math::quantile_position(size, alpha)],
+                prefix_sum(tail) / tail,
+                suffix_sum(size - tail) / tail
+            });
+        }
+        return measures;
+    }
+
+    inline std::vector<double> quantiles(const std::vector<double>& v, const std::vector<double>& alphas, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+        std::vector<double> result;
+        result.reserve(alphas.size());
+        for (auto& measure : owl::math::risk_measures(v, alphas, resource)) { result.push_back(measure.quantile); }
+        return result;
     }
 
-    inline double cvar_left(std::vector<double>& v, double alpha) {
-        return cvar(v, alpha, true);
+    inline double quantile(std::vector<double>& v, double alpha, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+        if (v.size() == 0) return 0;
+
+        std::pmr::vector<double> values(v.begin(), v.end(), resource);
+        auto nth = values.begin() + owl::math::quantile_position(values.size(), alpha);
+        std::nth_element(values.begin(), nth, values.end());
+        return *nth;
     }
 
-    inline double cvar_right(std::vector<double>& v, double alpha) {
-        return cvar(v, alpha, false);
+    inline double cvar(std::vector<double>& v, double alpha, bool left = true, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+        auto measure = owl::math::risk_measures(v, { alpha }, resource).front();
+        return left ? measure.cvar_left : measure.cvar_right;
     }
 
+    inline double cvar_left(std::vector<double>& v, double alpha, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+        return cvar(v, alpha, true, resource);
+    }
+
+    inline double cvar_right(std::vector<double>& v, double alpha, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+        return cvar(v, alpha, false, resource);
+    }
+
+    class accumulator {
+    public:
+        void add(double x) {
+            ++count_;
+
+            double delta = x - mean_;
+            mean_ += delta / count_;
+            m2_ += delta * (x - mean_);
+
+            add_to_sum(x);
+            product_ *= x;
+
+            if (x < minimum_) { minimum_ = x; }
+            if (x > maximum_) { maximum_ = x; }
+        }
+
+        template <typename iterator> void add(iterator first, iterator last) {
+            for (; first != last; ++first) { add(*first); }
+        }
+
+        void add(const std::vector<double>& v) {
+            add(v.begin(), v.end());
+        }
+
+        void merge(const accumulator& other) {
+            if (other.count_ == 0) { return; }
+            if (count_ == 0) {
+                *this = other;
+                return;
+            }
+
+            double count = static_cast<double>(count_ + other.count_);
+            double delta = other.mean_ - mean_;
+            mean_ += delta * (other.count_ / count);
+            m2_ += other.m2_ + delta * delta * (count_ * (other.count_ / count));
+            count_ += other.count_;
+
+            add_to_sum(other.sum_);
+            compensation_ += other.compensation_;
+            product_ *= other.product_;
+
+            if (other.minimum_ < minimum_) { minimum_ = other.minimum_; }
+            if (other.maximum_ > maximum_) { maximum_ = other.maximum_; }
+        }
+
+        std::size_t count() const { return count_; }
+        double mean() const { return mean_; }
+        double variance() const { return count_ < 2 ? 0 : m2_ / (count_ - 1); }
+        double stddev() const { return std::sqrt(variance()); }
+        double sum() const { return sum_ + compensation_; }
+        double product() const { return count_ == 0 ? 0 : product_; }
+        double minimum() const { return count_ == 0 ? 0 : minimum_; }
+        double maximum() const { return count_ == 0 ? 0 : maximum_; }
+
+    private:
+        void add_to_sum(double x) {
+            // Neumaier's variant of Kahan summation
+            double t = sum_ + x;
+            compensation_ += std::abs(sum_) >= std::abs(x) ? (sum_ - t) + x : (x - t) + sum_;
+            sum_ = t;
+        }
+
+        std::size_t count_ = 0;
+        double mean_ = 0;
+        double m2_ = 0;
+        double sum_ = 0;
+        double compensation_ = 0;
+        double product_ = 1;
+        double minimum_ = std::numeric_limits<double>::infinity();
+        double maximum_ = -std::numeric_limits<double>::infinity();
+    };
+
     inline double stddev(std::vector<double>& v) {
         auto size = v.size();
         if (size == 1) {
@@ -140,10 +328,7 @@ namespace owl::math {
         double sum = std::accumulate(v.begin(), v.end(), 0.0);
         double mean = sum / size;
 
-        std::vector<double> difference(v.size());
-        std::transform(v.begin(), v.end(), difference.begin(), [mean](double x) { return x - mean; });
-
-        double square_sum = std::inner_product(difference.begin(), difference.end(), difference.begin(), 0.0);
+        double square_sum = std::accumulate(v.begin(), v.end(), 0.0, [mean](double acc, double x) { return acc + (x - mean) * (x - mean); });
         return std::sqrt(square_sum / (size - 1));
     }
 
@@ -184,32 +369,202 @@ namespace owl::math {
         return std::make_pair(lb_index, ub_index);
     }
 
-    inline double npv(std::vector<double>& v, double rate) {
-        double sum = 0;
-        for (std::size_t i = 0, size = v.size(); i < size; ++i) { sum += v[i] / std::pow(1.0 + rate, i + 1); }
-        return sum;
+    // prebuilt version of find_nearest for repeated queries against the same breakpoints; returns exactly the same
+    // indices, answering in O(log n) or, when built with buckets, in expected O(1) through a uniform grid
+    class nearest_lookup {
+    public:
+        nearest_lookup() = default;
+
+        explicit nearest_lookup(const std::vector<double>& v, std::size_t buckets = 0) {
+            if (v.empty()) { return; }
+
+            std::vector<std::size_t> order(v.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::stable_sort(order.begin(), order.end(), [&v](std::size_t a, std::size_t b) { return v[a] < v[b]; });
+
+            for (auto i : order) {
+                if (values_.empty() || values_.back() != v[i]) {
+                    values_.push_back(v[i]);
+                    lower_index_.push_back(i);
+                    upper_index_.push_back(i);
+                }
+            }
+            // find_nearest falls back to the last occurrence of the maximum (as std::minmax_element reports it)
+            upper_index_.back() = order.back();
+
+            double range = values_.back() - values_.front();
+            if (buckets > 0 && range > 0) {
+                scale_ = buckets / range;
+                bucket_.resize(buckets);
+                for (std::size_t b = 0; b < buckets; ++b) {
+                    double edge = values_.front() + b / scale_;
+                    bucket_[b] = std::upper_bound(values_.begin(), values_.end(), edge) - values_.begin();
+                }
+            }
+        }
+
+        std::size_t size() const { return values_.size(); }
+
+        std::pair<std::size_t, std::size_t> find(double t) const {
+            if (values_.empty()) { return std::make_pair(0, 0); }
+            return bracket(t, position(t));
+        }
+
+        std::vector<std::pair<std::size_t, std::size_t>> find(const std::vector<double>& targets) const {
+            std::vector<std::pair<std::size_t, std::size_t>> result;
+            result.reserve(targets.size());
+            if (values_.empty()) {
+                result.assign(targets.size(), std::make_pair(0, 0));
+                return result;
+            }
+
+            if (std::is_sorted(targets.begin(), targets.end())) {
+                // monotone queries are answered with a single merge-style sweep over the breakpoints
+                std::size_t pos = 0, size = values_.size();
+                for (auto t : targets) {
+                    while (pos < size && values_[pos] <= t) { ++pos; }
+                    result.push_back(bracket(t, pos));
+                }
+            } else {
+                for (auto t : targets) { result.push_back(bracket(t, position(t))); }
+            }
+            return result;
+        }
+
+    private:
+        // number of distinct breakpoints less than or equal to t
+        std::size_t position(double t) const {
+            if (bucket_.empty()) {
+                return std::upper_bound(values_.begin(), values_.end(), t) - values_.begin();
+            }
+            if (t < values_.front()) { return 0; }
+            if (t >= values_.back()) { return values_.size(); }
+
+            auto b = (std::min)(static_cast<std::size_t>((t - values_.front()) * scale_), bucket_.size() - 1);
+            auto pos = bucket_[b];
+            while (pos > 0 && values_[pos - 1] > t) { --pos; }
+            while (pos < values_.size() && values_[pos] <= t) { ++pos; }
+            return pos;
+        }
+
+        std::pair<std::size_t, std::size_t> bracket(double t, std::size_t pos) const {
+            std::size_t lb = pos == 0 ? 0 : pos - 1;
+            std::size_t ub = (pos > 0 && values_[pos - 1] == t) ? pos - 1 : (std::min)(pos, values_.size() - 1);
+            return std::make_pair(lower_index_[lb], upper_index_[ub]);
+        }
+
+        std::vector<double> values_;
+        std::vector<std::size_t> lower_index_;
+        std::vector<std::size_t> upper_index_;
+        std::vector<std::size_t> bucket_;
+        double scale_ = 0;
+    };
+
+    inline constexpr std::size_t reduction_block = 1 << 15;
+
+    // calls f(i) for every i in [0, count) on the calling thread. The reductions below take it as their default
+    // schedule; owl/math_thread_pool.h passes one that spreads the calls over the thread pool instead
+    struct sequential_schedule {
+        template <typename function> void operator()(std::size_t count, function f) const {
+            for (std::size_t i = 0; i < count; ++i) { f(i); }
+        }
+    };
+
+    // splits [0, n) into fixed-size blocks and folds the per-block partials in block order, so the result depends
+    // only on n and never on how the schedule computed the partials
+    template <typename kernel, typename fold, typename schedule = sequential_schedule> inline double reduce(std::size_t n, kernel k, fold f, schedule for_each = schedule()) {
+        std::size_t blocks = (n + reduction_block - 1) / reduction_block;
+        if (blocks <= 1) { return k(0, n); }
+
+        std::vector<double> partials(blocks);
+        for_each(blocks, [&](std::size_t b) { partials[b] = k(b * reduction_block, (std::min)(n, (b + 1) * reduction_block)); });
+        return f(partials.data(), blocks);
+    }
+
+    // discount factors (1 + rate)^-(i + 1) for periods i in [first, first + 8), one per lane
+    inline void discount_seed(double rate, std::size_t first, double* seed) {
+        for (std::size_t j = 0; j < owl::simd::lanes; ++j) { seed[j] = std::pow(1.0 + rate, -static_cast<double>(first + j + 1)); }
+    }
+
+    // npv multiplies period i by (1 + rate)^-(i + 1). The factors are built incrementally, multiplying each lane by
+    // (1 + rate)^-8 per step and reseeding with std::pow at every reduction block, so they depend only on i and rate
+    template <typename schedule = sequential_schedule> inline double npv(std::vector<double>& v, double rate, schedule for_each = schedule()) {
+        const double* x = v.data();
+        const double step = std::pow(1.0 + rate, -static_cast<double>(owl::simd::lanes));
+        auto kernel = [x, rate, step](std::size_t first, std::size_t last) {
+            double seed[owl::simd::lanes];
+            discount_seed(rate, first, seed);
+            return owl::simd::discounted_sum(x + first, last - first, seed, step);
+        };
+        return v.size() == 0 ? 0 : reduce(v.size(), kernel, owl::simd::sum, for_each);
+    }
+
+    // the discount factors npv applies to periods [0, periods), generated the same way
+    inline std::vector<double> discount_table(double rate, std::size_t periods) {
+        std::vector<double> table(periods);
+        const double step = std::pow(1.0 + rate, -static_cast<double>(owl::simd::lanes));
+        for (std::size_t first = 0; first < periods; first += reduction_block) {
+            double seed[owl::simd::lanes];
+            discount_seed(rate, first, seed);
+            owl::simd::geometric(seed, step, (std::min)(periods - first, reduction_block), table.data() + first);
+        }
+        return table;
+    }
+
+    // npv of many series at many rates: flows holds series rows of periods cash flows each, and out[s * rate_count + r]
+    // receives the npv of series s at rates[r]. Every rate's factors are computed once and shared by all series; each
+    // series is a dot product over the same lanes and blocks as npv, so results match npv bit for bit. The schedule
+    // runs the series, not the blocks within one
+    template <typename schedule = sequential_schedule> inline void npv(const double* flows, std::size_t series, std::size_t periods, const double* rates, std::size_t rate_count, double* out, schedule for_each = schedule()) {
+        std::vector<std::vector<double>> tables;
+        for (std::size_t r = 0; r < rate_count; ++r) { tables.push_back(discount_table(rates[r], periods)); }
+
+        for_each(series, [&](std::size_t s) {
+            const double* x = flows + s * periods;
+            for (std::size_t r = 0; r < rate_count; ++r) {
+                const double* g = tables[r].data();
+                auto kernel = [x, g](std::size_t first, std::size_t last) { return owl::simd::dot(x + first, g + first, last - first); };
+                out[s * rate_count + r] = periods == 0 ? 0 : reduce(periods, kernel, owl::simd::sum);
+            }
+        });
+    }
+
+    // flows is (series, periods); the result is (series, rates)
+    template <typename schedule = sequential_schedule> inline ndarray<double, 2> npv(ndarray_view<const double, 2> flows, const std::vector<double>& rates, schedule for_each = schedule()) {
+        if (!flows.contiguous()) { throw std::runtime_error("owl::math::npv: cash flows must be contiguous"); }
+
+        ndarray<double, 2> out(extents(flows.shape(0), rates.size()));
+        npv(flows.data(), flows.shape(0), flows.shape(1), rates.data(), rates.size(), out.data(), for_each);
+        return out;
     }
 
-    inline double average(std::vector<double>& v) {
-        auto size = v.size();
-        return size == 0 ? 0 : (std::accumulate(std::begin(v), std::end(v), 0.0) / size);
+    template <typename schedule = sequential_schedule> inline double sum(std::vector<double>& v, schedule for_each = schedule()) {
+        const double* x = v.data();
+        auto kernel = [x](std::size_t first, std::size_t last) { return owl::simd::sum(x + first, last - first); };
+        return v.size() == 0 ? 0 : reduce(v.size(), kernel, owl::simd::sum, for_each);
     }
 
-    inline double multiply(std::vector<double>& v) {
+    template <typename schedule = sequential_schedule> inline double average(std::vector<double>& v, schedule for_each = schedule()) {
         auto size = v.size();
-        return size == 0 ? 0 : std::accumulate(std::begin(v), std::end(v), 1.0, std::multiplies<double>());
+        return size == 0 ? 0 : (owl::math::sum(v, for_each) / size);
     }
 
-    inline double sum(std::vector<double>& v) {
-        return v.size() == 0 ? 0 : std::accumulate(std::begin(v), std::end(v), 0.0);
+    template <typename schedule = sequential_schedule> inline double multiply(std::vector<double>& v, schedule for_each = schedule()) {
+        const double* x = v.data();
+        auto kernel = [x](std::size_t first, std::size_t last) { return owl::simd::product(x + first, last - first); };
+        return v.size() == 0 ? 0 : reduce(v.size(), kernel, owl::simd::product, for_each);
     }
 
-    inline double minimum(std::vector<double>& v) {
-        return v.size() == 0 ? 0 : *std::min_element(std::begin(v), std::end(v));
+    template <typename schedule = sequential_schedule> inline double minimum(std::vector<double>& v, schedule for_each = schedule()) {
+        const double* x = v.data();
+        auto kernel = [x](std::size_t first, std::size_t last) { return owl::simd::minimum(x + first, last - first); };
+        return v.size() == 0 ? 0 : reduce(v.size(), kernel, owl::simd::minimum, for_each);
     }
 
-    inline double maximum(std::vector<double>& v) {
-        return v.size() == 0 ? 0 : *std::max_element(std::begin(v), std::end(v));
+    template <typename schedule = sequential_schedule> inline double maximum(std::vector<double>& v, schedule for_each = schedule()) {
+        const double* x = v.data();
+        auto kernel = [x](std::size_t first, std::size_t last) { return owl::simd::maximum(x + first, last - first); };
+        return v.size() == 0 ? 0 : reduce(v.size(), kernel, owl::simd::maximum, for_each);
     }
 }
 
@@ -0,0 +1,63 @@
+#pragma once
+
+#ifndef OWL_MATH_THREAD_POOL_H
+#define OWL_MATH_THREAD_POOL_H
+
+#include <cstddef>
+#include <vector>
+
+#include <owl/math.h>
+#include <owl/thread_pool.h>
+
+namespace owl::math {
+    enum class execution { sequential, parallel };
+
+    // calls f(i) for every i in [0, count) on the default pool, grain indices per chunk (0 lets the pool choose)
+    struct thread_pool_schedule {
+        std::size_t grain = 0;
+
+        template <typename function> void operator()(std::size_t count, function f) const {
+            owl::parallel::parallel_for(0, count, f, grain);
+        }
+    };
+
+    // the parallel policy computes every reduction block on the pool; the results are the same as the sequential ones
+    inline double npv(std::vector<double>& v, double rate, execution policy) {
+        return policy == execution::parallel ? npv(v, rate, thread_pool_schedule{ 1 }) : npv(v, rate);
+    }
+
+    // the parallel policy splits the series across the pool
+    inline void npv(const double* flows, std::size_t series, std::size_t periods, const double* rates, std::size_t rate_count, double* out, execution policy) {
+        if (policy == execution::parallel) {
+            npv(flows, series, periods, rates, rate_count, out, thread_pool_schedule{});
+        } else {
+            npv(flows, series, periods, rates, rate_count, out);
+        }
+    }
+
+    inline ndarray<double, 2> npv(ndarray_view<const double, 2> flows, const std::vector<double>& rates, execution policy) {
+        return policy == execution::parallel ? npv(flows, rates, thread_pool_schedule{}) : npv(flows, rates);
+    }
+
+    inline double sum(std::vector<double>& v, execution policy) {
+        return policy == execution::parallel ? sum(v, thread_pool_schedule{ 1 }) : sum(v);
+    }
+
+    inline double average(std::vector<double>& v, execution policy) {
+        return policy == execution::parallel ? average(v, thread_pool_schedule{ 1 }) : average(v);
+    }
+
+    inline double multiply(std::vector<double>& v, execution policy) {
+        return policy == execution::parallel ? multiply(v, thread_pool_schedule{ 1 }) : multiply(v);
+    }
+
+    inline double minimum(std::vector<double>& v, execution policy) {
+        return policy == execution::parallel ? minimum(v, thread_pool_schedule{ 1 }) : minimum(v);
+    }
+
+    inline double maximum(std::vector<double>& v, execution policy) {
+        return policy == execution::parallel ? maximum(v, thread_pool_schedule{ 1 }) : maximum(v);
+    }
+}
+
+#endif
\ No newline at end of file
@@ -3,12 +3,73 @@
 #ifndef OWL_MEMORY_H
 #define OWL_MEMORY_H
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
 #ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
 #include <windows.h>
+#include <psapi.h>
 #else
+#include <sys/resource.h>
+#include <unistd.h>
 #endif
 
 namespace owl::memory {
+#ifndef _WIN32
+    // value of a "key: value kB" entry of a /proc file, in bytes; 0 when absent
+    inline std::uint64_t read_proc_kb(const char* path, const std::string& key) {
+        std::ifstream file(path);
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.compare(0, key.size(), key) == 0 && line.size() > key.size() && line[key.size()] == ':') {
+                std::uint64_t kb = 0;
+                std::istringstream(line.substr(key.size() + 1)) >> kb;
+                return kb * 1024;
+            }
+        }
+        return 0;
+    }
+
+    // first number of a cgroup interface file; 0 when absent or "max"
+    inline std::uint64_t read_cgroup_value(const std::string& path) {
+        std::ifstream file(path);
+        std::uint64_t value = 0;
+        if (!(file >> value)) { return 0; }
+        return value;
+    }
+
+    inline std::string cgroup_directory() {
+        // cgroup v2 lists the unified hierarchy as "0::/path"
+        std::ifstream file("/proc/self/cgroup");
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.compare(0, 3, "0::") == 0) {
+                std::string directory = "/sys/fs/cgroup" + line.substr(3);
+                if (std::ifstream(directory + "/memory.max")) { return directory; }
+            }
+        }
+        return "/sys/fs/cgroup";
+    }
+#endif
+
+    // physical memory in use by the whole system, in percent
     inline unsigned long load() {
 #ifdef _WIN32
         MEMORYSTATUSEX statex;
@@ -16,8 +77,244 @@ namespace owl::memory {
         GlobalMemoryStatusEx(&statex);
         return statex.dwMemoryLoad;
 #else
+        std::uint64_t total = read_proc_kb("/proc/meminfo", "MemTotal");
+        std::uint64_t available = read_proc_kb("/proc/meminfo", "MemAvailable");
+        return total == 0 ? 0 : static_cast<unsigned long>(((total - (std::min)(available, total)) * 100) / total);
+#endif
+    }
+
+    // bytes of physical memory installed
+    inline std::uint64_t total() {
+#ifdef _WIN32
+        MEMORYSTATUSEX statex;
+        statex.dwLength = sizeof(statex);
+        GlobalMemoryStatusEx(&statex);
+        return statex.ullTotalPhys;
+#else
+        return read_proc_kb("/proc/meminfo", "MemTotal");
 #endif
     }
+
+    // bytes the system can hand out without swapping
+    inline std::uint64_t available() {
+#ifdef _WIN32
+        MEMORYSTATUSEX statex;
+        statex.dwLength = sizeof(statex);
+        GlobalMemoryStatusEx(&statex);
+        return statex.ullAvailPhys;
+#else
+        return read_proc_kb("/proc/meminfo", "MemAvailable");
+#endif
+    }
+
+    // resident set size of this process, in bytes
+    inline std::uint64_t resident() {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters;
+        GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+        return counters.WorkingSetSize;
+#else
+        std::ifstream file("/proc/self/statm");
+        std::uint64_t size = 0, pages = 0;
+        file >> size >> pages;
+        return pages * static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE));
+#endif
+    }
+
+    // highest resident set size this process has reached, in bytes
+    inline std::uint64_t peak_resident() {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters;
+        GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+        return counters.PeakWorkingSetSize;
+#else
+        struct rusage usage;
+        ::getrusage(RUSAGE_SELF, &usage);
+        return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+    }
+
+    // memory limit of the control group (container or batch job) this process runs in, in bytes; 0 when unlimited
+    inline std::uint64_t cgroup_limit() {
+#ifdef _WIN32
+        return 0;
+#else
+        std::uint64_t limit = read_cgroup_value(cgroup_directory() + "/memory.max");
+        if (limit == 0) {
+            // cgroup v1 reports "unlimited" as a page-aligned value close to 2^63
+            limit = read_cgroup_value("/sys/fs/cgroup/memory/memory.limit_in_bytes");
+            if (limit >= (std::uint64_t(1) << 62)) { limit = 0; }
+        }
+        return limit;
+#endif
+    }
+
+    // bytes this process can still allocate: system available memory, capped by the room left under the cgroup limit
+    inline std::uint64_t budget() {
+        std::uint64_t room = available();
+#ifndef _WIN32
+        std::uint64_t limit = cgroup_limit();
+        if (limit > 0) {
+            std::uint64_t usage = read_cgroup_value(cgroup_directory() + "/memory.current");
+            if (usage == 0) { usage = read_cgroup_value("/sys/fs/cgroup/memory/memory.usage_in_bytes"); }
+            room = (std::min)(room, limit > usage ? limit - usage : 0);
+        }
+#endif
+        return room;
+    }
+
+    struct phase {
+        std::string name;
+        std::uint64_t start;
+        std::uint64_t peak;
+        double seconds;
+    };
+
+    // background thread polling resident() every interval and keeping the high-water mark of each named phase
+    class sampler {
+    public:
+        explicit sampler(std::chrono::milliseconds interval = std::chrono::milliseconds(10)) : interval_(interval), started_(std::chrono::steady_clock::now()) {
+            auto current = resident();
+            phases_.push_back({ "", current, current, 0 });
+            thread_ = std::thread([this] { run(); });
+        }
+
+        sampler(const sampler&) = delete;
+        sampler& operator=(const sampler&) = delete;
+
+        ~sampler() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stop_ = true;
+            }
+            wake_.notify_all();
+            thread_.join();
+        }
+
+        // closes the current phase and opens a new one
+        void begin(const std::string& name) {
+            auto current = resident();
+            auto now = std::chrono::steady_clock::now();
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            close(current, now);
+            phases_.push_back({ name, current, current, 0 });
+            started_ = now;
+        }
+
+        // every phase so far, the current one included (the unnamed first phase covers the time before begin)
+        std::vector<phase> phases() {
+            auto current = resident();
+            auto now = std::chrono::steady_clock::now();
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::vector<phase> result = phases_;
+            result.back().peak = (std::max)(result.back().peak, current);
+            result.back().seconds = std::chrono::duration<double>(now - started_).count();
+            return result;
+        }
+
+    private:
+        void close(std::uint64_t current, std::chrono::steady_clock::time_point now) {
+            phases_.back().peak = (std::max)(phases_.back().peak, current);
+            phases_.back().seconds = std::chrono::duration<double>(now - started_).count();
+        }
+
+        void run() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (!stop_) {
+                wake_.wait_for(lock, interval_, [this] { return stop_; });
+                lock.unlock();
+                auto current = resident();
+                lock.lock();
+                phases_.back().peak = (std::max)(phases_.back().peak, current);
+            }
+        }
+
+        std::chrono::milliseconds interval_;
+        std::chrono::steady_clock::time_point started_;
+        std::vector<phase> phases_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::thread thread_;
+        bool stop_ = false;
+    };
+
+    // monotonic allocator for scenario-scoped temporaries: allocation bumps a pointer, deallocation is a no-op and
+    // reset() makes every block reusable at once without returning memory to the system
+    class arena : public std::pmr::memory_resource {
+    public:
+        explicit arena(std::size_t initial = 1 << 20, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) : initial_(initial), upstream_(upstream) {}
+
+        arena(const arena&) = delete;
+        arena& operator=(const arena&) = delete;
+
+        ~arena() override {
+            for (auto& b : blocks_) { upstream_->deallocate(b.data, b.size, alignof(std::max_align_t)); }
+        }
+
+        void reset() {
+            current_ = 0;
+            offset_ = 0;
+            used_ = 0;
+        }
+
+        // bytes handed out since the last reset
+        std::size_t used() const { return used_; }
+
+        // bytes reserved from upstream
+        std::size_t capacity() const {
+            std::size_t capacity = 0;
+            for (auto& b : blocks_) { capacity += b.size; }
+            return capacity;
+        }
+
+    private:
+        struct block {
+            std::byte* data;
+            std::size_t size;
+        };
+
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+            while (current_ < blocks_.size()) {
+                auto& b = blocks_[current_];
+                auto address = reinterpret_cast<std::uintptr_t>(b.data) + offset_;
+                std::size_t aligned = offset_ + (((address + alignment - 1) & ~(std::uintptr_t)(alignment - 1)) - address);
+                if (aligned + bytes <= b.size) {
+                    offset_ = aligned + bytes;
+                    used_ += bytes;
+                    return b.data + aligned;
+                }
+                ++current_;
+                offset_ = 0;
+            }
+
+            std::size_t size = (std::max)(blocks_.empty() ? initial_ : blocks_.back().size * 2, bytes + alignment);
+            blocks_.push_back({ static_cast<std::byte*>(upstream_->allocate(size, alignof(std::max_align_t))), size });
+            current_ = blocks_.size() - 1;
+            offset_ = 0;
+            return do_allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+        std::size_t initial_;
+        std::pmr::memory_resource* upstream_;
+        std::vector<block> blocks_;
+        std::size_t current_ = 0;
+        std::size_t offset_ = 0;
+        std::size_t used_ = 0;
+    };
+
+    // per-thread scratch arena; reset it at the end of each scenario
+    inline arena& scratch() {
+        thread_local arena instance;
+        return instance;
+    }
 }
 
 #endif
\ No newline at end of file
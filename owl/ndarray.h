@@ -0,0 +1,186 @@
+#pragma once
+
+#ifndef OWL_NDARRAY_H
+#define OWL_NDARRAY_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace owl::math {
+    template <typename type, std::size_t alignment = 64> struct aligned_allocator {
+        using value_type = type;
+
+        template <typename other_type> struct rebind {
+            using other = aligned_allocator<other_type, alignment>;
+        };
+
+        aligned_allocator() noexcept = default;
+
+        template <typename other_type> aligned_allocator(const aligned_allocator<other_type, alignment>&) noexcept {}
+
+        type* allocate(std::size_t n) {
+            return static_cast<type*>(::operator new(n * sizeof(type), std::align_val_t(alignment)));
+        }
+
+        void deallocate(type* p, std::size_t) noexcept {
+            ::operator delete(p, std::align_val_t(alignment));
+        }
+
+        template <typename other_type> bool operator==(const aligned_allocator<other_type, alignment>&) const noexcept { return true; }
+        template <typename other_type> bool operator!=(const aligned_allocator<other_type, alignment>&) const noexcept { return false; }
+    };
+
+    template <typename... dims> inline std::array<std::size_t, sizeof...(dims)> extents(dims... d) {
+        return { static_cast<std::size_t>(d)... };
+    }
+
+    template <std::size_t N> inline std::array<std::size_t, N> row_major_strides(const std::array<std::size_t, N>& shape) {
+        std::array<std::size_t, N> strides;
+        std::size_t stride = 1;
+        for (std::size_t axis = N; axis-- > 0;) {
+            strides[axis] = stride;
+            stride *= shape[axis];
+        }
+        return strides;
+    }
+
+    template <typename type, std::size_t N> class ndarray_view {
+        static_assert(N >= 1, "ndarray_view requires at least one dimension");
+
+    public:
+        using value_type = std::remove_const_t<type>;
+        using shape_type = std::array<std::size_t, N>;
+
+        ndarray_view() : data_(nullptr), shape_{}, strides_{} {}
+
+        ndarray_view(type* data, const shape_type& shape) : data_(data), shape_(shape), strides_(row_major_strides(shape)) {}
+
+        ndarray_view(type* data, const shape_type& shape, const shape_type& strides) : data_(data), shape_(shape), strides_(strides) {}
+
+        operator ndarray_view<const type, N>() const {
+            return ndarray_view<const type, N>(data_, shape_, strides_);
+        }
+
+        type* data() const { return data_; }
+        const shape_type& shape() const { return shape_; }
+        std::size_t shape(std::size_t axis) const { return shape_[axis]; }
+        const shape_type& strides() const { return strides_; }
+
+        std::size_t size() const {
+            std::size_t size = 1;
+            for (auto d : shape_) { size *= d; }
+            return size;
+        }
+
+        bool contiguous() const {
+            return strides_ == row_major_strides(shape_);
+        }
+
+        template <typename... index> type& operator()(index... i) const {
+            static_assert(sizeof...(index) == N, "wrong number of indices");
+            std::size_t offset = 0, axis = 0;
+            ((offset += static_cast<std::size_t>(i) * strides_[axis++]), ...);
+            return data_[offset];
+        }
+
+        decltype(auto) operator[](std::size_t i) const {
+            if constexpr (N == 1) {
+                return data_[i * strides_[0]];
+            } else {
+                std::array<std::size_t, N - 1> shape, strides;
+                std::copy(shape_.begin() + 1, shape_.end(), shape.begin());
+                std::copy(strides_.begin() + 1, strides_.end(), strides.begin());
+                return ndarray_view<type, N - 1>(data_ + i * strides_[0], shape, strides);
+            }
+        }
+
+        ndarray_view slice(std::size_t axis, std::size_t first, std::size_t last) const {
+            auto shape = shape_;
+            shape[axis] = last - first;
+            return ndarray_view(data_ + first * strides_[axis], shape, strides_);
+        }
+
+        template <typename function> void for_each(function f) const {
+            if (contiguous()) {
+                for (type *p = data_, *end = data_ + size(); p != end; ++p) { f(*p); }
+            } else {
+                for (std::size_t i = 0; i < shape_[0]; ++i) {
+                    if constexpr (N == 1) { f((*this)[i]); } else { (*this)[i].for_each(f); }
+                }
+            }
+        }
+
+        void fill(const value_type& value) const {
+            for_each([&value](type& x) { x = value; });
+        }
+
+    private:
+        type* data_;
+        shape_type shape_;
+        shape_type strides_;
+    };
+
+    template <typename type, std::size_t N> class ndarray {
+        static_assert(N >= 1, "ndarray requires at least one dimension");
+
+    public:
+        using value_type = type;
+        using shape_type = std::array<std::size_t, N>;
+        using storage_type = std::vector<type, aligned_allocator<type>>;
+
+        ndarray() : shape_{}, strides_{} {}
+
+        explicit ndarray(const shape_type& shape) : shape_(shape), strides_(row_major_strides(shape)), data_(count(shape)) {}
+
+        ndarray(const shape_type& shape, const type& value) : shape_(shape), strides_(row_major_strides(shape)), data_(count(shape), value) {}
+
+        type* data() { return data_.data(); }
+        const type* data() const { return data_.data(); }
+        const shape_type& shape() const { return shape_; }
+        std::size_t shape(std::size_t axis) const { return shape_[axis]; }
+        const shape_type& strides() const { return strides_; }
+        std::size_t size() const { return data_.size(); }
+        bool empty() const { return data_.empty(); }
+
+        type* begin() { return data_.data(); }
+        type* end() { return data_.data() + data_.size(); }
+        const type* begin() const { return data_.data(); }
+        const type* end() const { return data_.data() + data_.size(); }
+
+        ndarray_view<type, N> view() { return ndarray_view<type, N>(data_.data(), shape_, strides_); }
+        ndarray_view<const type, N> view() const { return ndarray_view<const type, N>(data_.data(), shape_, strides_); }
+
+        operator ndarray_view<type, N>() { return view(); }
+        operator ndarray_view<const type, N>() const { return view(); }
+
+        template <typename... index> type& operator()(index... i) { return view()(i...); }
+        template <typename... index> const type& operator()(index... i) const { return view()(i...); }
+
+        decltype(auto) operator[](std::size_t i) { return view()[i]; }
+        decltype(auto) operator[](std::size_t i) const { return view()[i]; }
+
+        ndarray_view<type, N> slice(std::size_t axis, std::size_t first, std::size_t last) { return view().slice(axis, first, last); }
+        ndarray_view<const type, N> slice(std::size_t axis, std::size_t first, std::size_t last) const { return view().slice(axis, first, last); }
+
+        void fill(const type& value) {
+            std::fill(data_.begin(), data_.end(), value);
+        }
+
+    private:
+        static std::size_t count(const shape_type& shape) {
+            std::size_t size = 1;
+            for (auto d : shape) { size *= d; }
+            return size;
+        }
+
+        shape_type shape_;
+        shape_type strides_;
+        storage_type data_;
+    };
+}
+
+#endif
\ No newline at end of file
@@ -5,10 +5,22 @@
 
 #include "mpi.h"
 
+#include <algorithm>
 #include <cmath>
+#include <complex>
+#include <cstddef>
+#include <utility>
 #include <vector>
 
 namespace owl::parallel {
+    // initializes MPI asking for the given thread support level and returns the level actually provided; hybrid runs
+    // that only call MPI from the main thread need MPI_THREAD_FUNNELED, MPI calls from pool threads need MPI_THREAD_MULTIPLE
+    inline int initialize(int* argc, char*** argv, int required = MPI_THREAD_FUNNELED) {
+        int provided = MPI_THREAD_SINGLE;
+        MPI_Init_thread(argc, argv, required, &provided);
+        return provided;
+    }
+
     inline int rank() {
         int world_rank;
         MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
@@ -69,6 +81,279 @@ namespace owl::parallel {
         }
         return displacement;
     }
+
+    template <typename type> inline MPI_Datatype datatype();
+    template <> inline MPI_Datatype datatype<char>() { return MPI_CHAR; }
+    template <> inline MPI_Datatype datatype<signed char>() { return MPI_SIGNED_CHAR; }
+    template <> inline MPI_Datatype datatype<unsigned char>() { return MPI_UNSIGNED_CHAR; }
+    template <> inline MPI_Datatype datatype<short>() { return MPI_SHORT; }
+    template <> inline MPI_Datatype datatype<unsigned short>() { return MPI_UNSIGNED_SHORT; }
+    template <> inline MPI_Datatype datatype<int>() { return MPI_INT; }
+    template <> inline MPI_Datatype datatype<unsigned int>() { return MPI_UNSIGNED; }
+    template <> inline MPI_Datatype datatype<long>() { return MPI_LONG; }
+    template <> inline MPI_Datatype datatype<unsigned long>() { return MPI_UNSIGNED_LONG; }
+    template <> inline MPI_Datatype datatype<long long>() { return MPI_LONG_LONG; }
+    template <> inline MPI_Datatype datatype<unsigned long long>() { return MPI_UNSIGNED_LONG_LONG; }
+    template <> inline MPI_Datatype datatype<float>() { return MPI_FLOAT; }
+    template <> inline MPI_Datatype datatype<double>() { return MPI_DOUBLE; }
+    template <> inline MPI_Datatype datatype<long double>() { return MPI_LONG_DOUBLE; }
+    template <> inline MPI_Datatype datatype<bool>() { return MPI_CXX_BOOL; }
+    template <> inline MPI_Datatype datatype<std::complex<double>>() { return MPI_CXX_DOUBLE_COMPLEX; }
+
+    // element counts per rank when every task contributes block elements, following get_tasks_per_process
+    inline std::vector<int> get_counts(int total_tasks, int block = 1) {
+        std::vector<int> counts = get_tasks_per_process(total_tasks);
+        for (auto& count : counts) { count *= block; }
+        return counts;
+    }
+
+    // handle of a non-blocking collective; owns the receive buffer and the count/displacement arrays, which MPI
+    // requires to stay alive until completion. The caller's send buffer must not be touched before wait() returns
+    template <typename type> struct request {
+        MPI_Request handle = MPI_REQUEST_NULL;
+        std::vector<int> counts;
+        std::vector<int> displacement;
+        std::vector<type> buffer;
+
+        request() = default;
+        request(const request&) = delete;
+        request& operator=(const request&) = delete;
+
+        request(request&& other) noexcept : handle(std::exchange(other.handle, MPI_REQUEST_NULL)), counts(std::move(other.counts)), displacement(std::move(other.displacement)), buffer(std::move(other.buffer)) {}
+
+        request& operator=(request&& other) noexcept {
+            if (this != &other) {
+                wait();
+                handle = std::exchange(other.handle, MPI_REQUEST_NULL);
+                counts = std::move(other.counts);
+                displacement = std::move(other.displacement);
+                buffer = std::move(other.buffer);
+            }
+            return *this;
+        }
+
+        ~request() {
+            wait();
+        }
+
+        bool test() {
+            int flag = 1;
+            if (handle != MPI_REQUEST_NULL) { MPI_Test(&handle, &flag, MPI_STATUS_IGNORE); }
+            return flag != 0;
+        }
+
+        std::vector<type>& wait() {
+            if (handle != MPI_REQUEST_NULL) { MPI_Wait(&handle, MPI_STATUS_IGNORE); }
+            return buffer;
+        }
+    };
+
+    // gathers every rank's block of the task partition on root, in rank order; out needs total_tasks * block elements on root
+    template <typename type> inline void gather(const type* local, type* out, int total_tasks, int root = 0, int block = 1) {
+        std::vector<int> counts = get_counts(total_tasks, block);
+        std::vector<int> displacement = get_displacement(counts);
+        MPI_Gatherv(local, counts[rank()], datatype<type>(), out, counts.data(), displacement.data(), datatype<type>(), root, MPI_COMM_WORLD);
+    }
+
+    template <typename type> inline std::vector<type> gather(const std::vector<type>& local, int total_tasks, int root = 0, int block = 1) {
+        std::vector<type> out(rank() == root ? static_cast<std::size_t>(total_tasks) * block : 0);
+        gather(local.data(), out.data(), total_tasks, root, block);
+        return out;
+    }
+
+    template <typename type> inline void allgather(const type* local, type* out, int total_tasks, int block = 1) {
+        std::vector<int> counts = get_counts(total_tasks, block);
+        std::vector<int> displacement = get_displacement(counts);
+        MPI_Allgatherv(local, counts[rank()], datatype<type>(), out, counts.data(), displacement.data(), datatype<type>(), MPI_COMM_WORLD);
+    }
+
+    template <typename type> inline std::vector<type> allgather(const std::vector<type>& local, int total_tasks, int block = 1) {
+        std::vector<type> out(static_cast<std::size_t>(total_tasks) * block);
+        allgather(local.data(), out.data(), total_tasks, block);
+        return out;
+    }
+
+    // element-wise reduction in place; only root holds the result
+    template <typename type> inline void reduce(type* data, int count, MPI_Op op = MPI_SUM, int root = 0) {
+        if (rank() == root) {
+            MPI_Reduce(MPI_IN_PLACE, data, count, datatype<type>(), op, root, MPI_COMM_WORLD);
+        } else {
+            MPI_Reduce(data, nullptr, count, datatype<type>(), op, root, MPI_COMM_WORLD);
+        }
+    }
+
+    template <typename type> inline void reduce(std::vector<type>& v, MPI_Op op = MPI_SUM, int root = 0) {
+        reduce(v.data(), static_cast<int>(v.size()), op, root);
+    }
+
+    template <typename type> inline void allreduce(type* data, int count, MPI_Op op = MPI_SUM) {
+        MPI_Allreduce(MPI_IN_PLACE, data, count, datatype<type>(), op, MPI_COMM_WORLD);
+    }
+
+    template <typename type> inline void allreduce(std::vector<type>& v, MPI_Op op = MPI_SUM) {
+        allreduce(v.data(), static_cast<int>(v.size()), op);
+    }
+
+    template <typename type> inline type allreduce(type value, MPI_Op op = MPI_SUM) {
+        allreduce(&value, 1, op);
+        return value;
+    }
+
+    template <typename type> inline void broadcast(type* data, int count, int root = 0) {
+        MPI_Bcast(data, count, datatype<type>(), root, MPI_COMM_WORLD);
+    }
+
+    // resizes v on the receiving ranks to match root
+    template <typename type> inline void broadcast(std::vector<type>& v, int root = 0) {
+        unsigned long long size = v.size();
+        broadcast(&size, 1, root);
+        v.resize(size);
+        broadcast(v.data(), static_cast<int>(size), root);
+    }
+
+    template <typename type> inline request<type> igather(const type* local, int total_tasks, int root = 0, int block = 1) {
+        request<type> r;
+        r.counts = get_counts(total_tasks, block);
+        r.displacement = get_displacement(r.counts);
+        r.buffer.resize(rank() == root ? static_cast<std::size_t>(total_tasks) * block : 0);
+        MPI_Igatherv(local, r.counts[rank()], datatype<type>(), r.buffer.data(), r.counts.data(), r.displacement.data(), datatype<type>(), root, MPI_COMM_WORLD, &r.handle);
+        return r;
+    }
+
+    template <typename type> inline request<type> igather(const std::vector<type>& local, int total_tasks, int root = 0, int block = 1) {
+        return igather(local.data(), total_tasks, root, block);
+    }
+
+    template <typename type> inline request<type> iallgather(const type* local, int total_tasks, int block = 1) {
+        request<type> r;
+        r.counts = get_counts(total_tasks, block);
+        r.displacement = get_displacement(r.counts);
+        r.buffer.resize(static_cast<std::size_t>(total_tasks) * block);
+        MPI_Iallgatherv(local, r.counts[rank()], datatype<type>(), r.buffer.data(), r.counts.data(), r.displacement.data(), datatype<type>(), MPI_COMM_WORLD, &r.handle);
+        return r;
+    }
+
+    template <typename type> inline request<type> iallgather(const std::vector<type>& local, int total_tasks, int block = 1) {
+        return iallgather(local.data(), total_tasks, block);
+    }
+
+    // the in-place variants below complete into the caller's vector, which must outlive the request
+    template <typename type> inline request<type> ireduce(std::vector<type>& v, MPI_Op op = MPI_SUM, int root = 0) {
+        request<type> r;
+        if (rank() == root) {
+            MPI_Ireduce(MPI_IN_PLACE, v.data(), static_cast<int>(v.size()), datatype<type>(), op, root, MPI_COMM_WORLD, &r.handle);
+        } else {
+            MPI_Ireduce(v.data(), nullptr, static_cast<int>(v.size()), datatype<type>(), op, root, MPI_COMM_WORLD, &r.handle);
+        }
+        return r;
+    }
+
+    template <typename type> inline request<type> iallreduce(std::vector<type>& v, MPI_Op op = MPI_SUM) {
+        request<type> r;
+        MPI_Iallreduce(MPI_IN_PLACE, v.data(), static_cast<int>(v.size()), datatype<type>(), op, MPI_COMM_WORLD, &r.handle);
+        return r;
+    }
+
+    // v must already have the same size on every rank
+    template <typename type> inline request<type> ibroadcast(std::vector<type>& v, int root = 0) {
+        request<type> r;
+        MPI_Ibcast(v.data(), static_cast<int>(v.size()), datatype<type>(), root, MPI_COMM_WORLD, &r.handle);
+        return r;
+    }
+
+    struct schedule_report {
+        std::vector<int> tasks;
+        std::vector<double> busy;
+
+        // slowest rank's busy time over the mean busy time; 1 means perfectly balanced
+        double imbalance() const {
+            if (busy.empty()) { return 1; }
+            double total = 0, slowest = 0;
+            for (auto b : busy) { total += b; slowest = (std::max)(slowest, b); }
+            return total > 0 ? slowest / (total / busy.size()) : 1;
+        }
+    };
+
+    // dynamic alternative to the static get_tasks partition: ranks claim chunks of task indices on demand through an
+    // atomic counter exposed by rank 0 (MPI one-sided Fetch_and_op), so no rank is dedicated to coordinating. Chunk sizes
+    // follow guided self-scheduling, shrinking from total / (2 * size) down to min_chunk as the queue drains.
+    // Construction and destruction are collective.
+    class scheduler {
+    public:
+        explicit scheduler(int total_tasks, int min_chunk = 1) {
+            int world_size = size();
+            min_chunk = (std::max)(min_chunk, 1);
+            for (int first = 0; first < total_tasks;) {
+                int remaining = total_tasks - first;
+                int chunk = (std::min)(remaining, (std::max)(min_chunk, (remaining + 2 * world_size - 1) / (2 * world_size)));
+                chunks_.push_back(first);
+                first += chunk;
+            }
+            chunks_.push_back(total_tasks);
+
+            int* counter = nullptr;
+            MPI_Win_allocate(rank() == 0 ? sizeof(int) : 0, sizeof(int), MPI_INFO_NULL, MPI_COMM_WORLD, &counter, &window_);
+            if (rank() == 0) { *counter = 0; }
+            MPI_Barrier(MPI_COMM_WORLD);
+            MPI_Win_lock_all(MPI_MODE_NOCHECK, window_);
+        }
+
+        scheduler(const scheduler&) = delete;
+        scheduler& operator=(const scheduler&) = delete;
+
+        ~scheduler() {
+            MPI_Win_unlock_all(window_);
+            MPI_Win_free(&window_);
+        }
+
+        // claims the next chunk [first, last); returns false once every task has been handed out
+        bool next(int& first, int& last) {
+            double now = MPI_Wtime();
+            if (claimed_) { busy_ += now - started_; }
+
+            const int one = 1;
+            int chunk = 0;
+            MPI_Fetch_and_op(&one, &chunk, MPI_INT, 0, 0, MPI_SUM, window_);
+            MPI_Win_flush(0, window_);
+
+            claimed_ = chunk < static_cast<int>(chunks_.size()) - 1;
+            if (!claimed_) { return false; }
+
+            first = chunks_[chunk];
+            last = chunks_[chunk + 1];
+            tasks_ += last - first;
+            started_ = MPI_Wtime();
+            return true;
+        }
+
+        template <typename function> void run(function f) {
+            int first, last;
+            while (next(first, last)) {
+                for (int task = first; task < last; ++task) { f(task); }
+            }
+        }
+
+        int tasks() const { return tasks_; }
+        double busy() const { return busy_; }
+
+        // collective: task counts and busy seconds of every rank, indexed by rank
+        schedule_report report() const {
+            schedule_report r;
+            r.tasks.resize(size());
+            r.busy.resize(size());
+            MPI_Allgather(&tasks_, 1, MPI_INT, r.tasks.data(), 1, MPI_INT, MPI_COMM_WORLD);
+            MPI_Allgather(&busy_, 1, MPI_DOUBLE, r.busy.data(), 1, MPI_DOUBLE, MPI_COMM_WORLD);
+            return r;
+        }
+
+    private:
+        std::vector<int> chunks_;
+        MPI_Win window_ = MPI_WIN_NULL;
+        int tasks_ = 0;
+        double busy_ = 0;
+        double started_ = 0;
+        bool claimed_ = false;
+    };
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+
+#ifndef OWL_PARALLEL_CHECKPOINT_H
+#define OWL_PARALLEL_CHECKPOINT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include <owl/checkpoint.h>
+#include <owl/parallel.h>
+
+namespace owl::parallel {
+    // Collective: each rank passes its block of rows, in rank order, of one array, and path ends up holding the whole
+    // array with its checksum. Rows sit at fixed offsets, so a run with any other rank count can read the file back
+    template <typename type, std::size_t N> inline void save_checkpoint(const std::string& path, owl::math::ndarray_view<const type, N> local, int root = 0) {
+        std::uint64_t rows = local.shape(0), first = 0;
+        MPI_Exscan(&rows, &first, 1, datatype<std::uint64_t>(), MPI_SUM, MPI_COMM_WORLD);
+        if (rank() == 0) { first = 0; }
+
+        auto shape = local.shape();
+        shape[0] = static_cast<std::size_t>(allreduce(rows));
+        for (std::size_t axis = 1; axis < N; ++axis) { shape[axis] = static_cast<std::size_t>(allreduce(static_cast<std::uint64_t>(shape[axis]), MPI_MAX)); }
+
+        if (rank() == root) { owl::checkpoint::create(path, owl::checkpoint::make_header<type>(shape)); }
+        MPI_Barrier(MPI_COMM_WORLD);
+
+        owl::checkpoint::writer<type, N> out(path);
+        out.write(static_cast<std::size_t>(first), local);
+        out.close();
+
+        std::uint64_t checksum = allreduce(out.partial());
+        if (rank() == root) { owl::checkpoint::finalize(path, checksum); }
+        MPI_Barrier(MPI_COMM_WORLD);
+    }
+
+    template <typename type, std::size_t N> inline void save_checkpoint(const std::string& path, const owl::math::ndarray<type, N>& local, int root = 0) {
+        save_checkpoint(path, local.view(), root);
+    }
+
+    // Collective: each rank gets its get_tasks/get_initial_task block of rows, whatever the rank count that wrote the
+    // file. Ranks checksum only their own rows and the sums are compared against the header
+    template <typename type, std::size_t N> inline owl::math::ndarray<type, N> load_checkpoint(const std::string& path) {
+        owl::checkpoint::reader in(path);
+        int total = static_cast<int>(in.rows());
+        std::size_t first = get_initial_task(total);
+        std::size_t last = first + get_tasks(total);
+
+        auto view = in.rows<type, N>(first, last);
+        if (allreduce(in.checksum(first, last)) != in.info().checksum) { throw std::runtime_error("owl::parallel::load_checkpoint: " + path + " checksum mismatch"); }
+
+        owl::math::ndarray<type, N> local(view.shape());
+        std::copy(view.data(), view.data() + view.size(), local.data());
+        return local;
+    }
+}
+
+#endif
\ No newline at end of file
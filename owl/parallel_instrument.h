@@ -0,0 +1,118 @@
+#pragma once
+
+#ifndef OWL_PARALLEL_INSTRUMENT_H
+#define OWL_PARALLEL_INSTRUMENT_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <owl/instrument.h>
+#include <owl/parallel.h>
+
+namespace owl::parallel {
+    struct region_summary {
+        std::string name;
+        std::uint64_t calls;
+        double minimum;
+        double mean;
+        double maximum;
+
+        // slowest rank over the mean rank; 1 means perfectly balanced
+        double imbalance() const { return mean > 0 ? maximum / mean : 1; }
+    };
+
+    // collective: every name any rank registered, in sorted order, so all ranks reduce the same index space
+    inline std::vector<std::string> union_of_names(const std::vector<std::string>& names) {
+        std::string local;
+        for (auto& n : names) { local += n + '\n'; }
+
+        int length = static_cast<int>(local.size());
+        std::vector<int> lengths(size());
+        MPI_Allgather(&length, 1, MPI_INT, lengths.data(), 1, MPI_INT, MPI_COMM_WORLD);
+        std::vector<int> displacement = get_displacement(lengths);
+
+        std::string all(displacement.back() + lengths.back(), '\0');
+        MPI_Allgatherv(local.data(), length, MPI_CHAR, all.data(), lengths.data(), displacement.data(), MPI_CHAR, MPI_COMM_WORLD);
+
+        std::vector<std::string> result;
+        for (std::size_t start = 0, end; start < all.size(); start = end + 1) {
+            end = all.find('\n', start);
+            result.push_back(all.substr(start, end - start));
+        }
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+        return result;
+    }
+
+    // collective: total seconds of each instrumented region per rank, reduced to min, mean and max across ranks (ranks
+    // that never entered a region count as 0) and summed call counts
+    inline std::vector<region_summary> summarize(const owl::instrument::snapshot& s) {
+        std::vector<std::string> local;
+        for (auto& r : s.regions) { local.push_back(r.name); }
+        std::vector<std::string> names = union_of_names(local);
+
+        std::vector<double> totals(names.size(), 0);
+        std::vector<unsigned long long> calls(names.size(), 0);
+        for (auto& r : s.regions) {
+            std::size_t index = std::lower_bound(names.begin(), names.end(), r.name) - names.begin();
+            totals[index] = r.total;
+            calls[index] = r.calls;
+        }
+
+        std::vector<double> minimum = totals, maximum = totals;
+        allreduce(minimum, MPI_MIN);
+        allreduce(maximum, MPI_MAX);
+        allreduce(totals, MPI_SUM);
+        allreduce(calls, MPI_SUM);
+
+        std::vector<region_summary> result;
+        for (std::size_t i = 0; i < names.size(); ++i) {
+            result.push_back({ names[i], calls[i], minimum[i], totals[i] / size(), maximum[i] });
+        }
+        return result;
+    }
+
+    // collective: counters summed across ranks
+    inline std::vector<owl::instrument::counter> summarize_counters(const owl::instrument::snapshot& s) {
+        std::vector<std::string> local;
+        for (auto& c : s.counters) { local.push_back(c.name); }
+        std::vector<std::string> names = union_of_names(local);
+
+        std::vector<double> values(names.size(), 0);
+        for (auto& c : s.counters) { values[std::lower_bound(names.begin(), names.end(), c.name) - names.begin()] = c.value; }
+        allreduce(values, MPI_SUM);
+
+        std::vector<owl::instrument::counter> result;
+        for (std::size_t i = 0; i < names.size(); ++i) { result.push_back({ names[i], values[i] }); }
+        return result;
+    }
+
+    // collective: writes the per-region imbalance table and the summed counters on root
+    inline void report(std::ostream& out, const owl::instrument::snapshot& s, int root = 0) {
+        auto regions = summarize(s);
+        auto counters = summarize_counters(s);
+        if (rank() != root) { return; }
+
+        char line[256];
+        std::snprintf(line, sizeof line, "%-32s %12s %14s %14s %14s %10s\n", "region", "calls", "min [s]", "mean [s]", "max [s]", "imbalance");
+        out << line;
+        for (auto& r : regions) {
+            std::snprintf(line, sizeof line, "%-32s %12llu %14.6f %14.6f %14.6f %10.3f\n", r.name.c_str(), static_cast<unsigned long long>(r.calls), r.minimum, r.mean, r.maximum, r.imbalance());
+            out << line;
+        }
+        if (counters.empty()) { return; }
+
+        std::snprintf(line, sizeof line, "%-32s %14s\n", "counter", "total");
+        out << line;
+        for (auto& c : counters) {
+            std::snprintf(line, sizeof line, "%-32s %14.6g\n", c.name.c_str(), c.value);
+            out << line;
+        }
+    }
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,19 @@
+#pragma once
+
+#ifndef OWL_PARALLEL_RANDOM_H
+#define OWL_PARALLEL_RANDOM_H
+
+#include <cstdint>
+
+#include <owl/parallel.h>
+#include <owl/random.h>
+
+namespace owl::parallel {
+    // generator keyed by (seed, rank, keys...); prefer owl::random::stream(seed, scenario) when draws must not depend
+    // on how scenarios are distributed over ranks
+    template <typename... keys> inline owl::random::generator rank_stream(std::uint64_t seed, keys... k) {
+        return owl::random::stream(seed, static_cast<std::uint64_t>(rank()), k...);
+    }
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,20 @@
+#pragma once
+
+#ifndef OWL_PARALLEL_THREAD_POOL_H
+#define OWL_PARALLEL_THREAD_POOL_H
+
+#include <cstddef>
+
+#include <owl/parallel.h>
+#include <owl/thread_pool.h>
+
+namespace owl::parallel {
+    // hybrid partition: the rank takes its static block of get_tasks/get_initial_task and the pool threads share it
+    template <typename function> inline void for_each_task(int total_tasks, function f, thread_pool& pool = default_pool()) {
+        std::size_t first = get_initial_task(total_tasks);
+        std::size_t last = first + get_tasks(total_tasks);
+        pool.parallel_for(first, last, [&f](std::size_t task) { f(static_cast<int>(task)); }, 1);
+    }
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,171 @@
+#pragma once
+
+#ifndef OWL_RANDOM_H
+#define OWL_RANDOM_H
+
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <owl/constant.h>
+
+namespace owl::random {
+    // SplitMix64 step: advances state and returns a well-mixed 64-bit value
+    inline std::uint64_t splitmix64(std::uint64_t& state) {
+        std::uint64_t z = (state += 0x9e3779b97f4a7c15);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+        return z ^ (z >> 31);
+    }
+
+    // xoshiro256** (Blackman and Vigna): 256 bits of state, period 2^256 - 1, a few nanoseconds per draw. Satisfies
+    // UniformRandomBitGenerator, so it also works with the <random> distributions
+    class generator {
+    public:
+        using result_type = std::uint64_t;
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        explicit generator(std::uint64_t seed = 0) {
+            std::uint64_t state = seed;
+            for (auto& word : s_) { word = splitmix64(state); }
+        }
+
+        // independent stream for a tuple of keys, e.g. (seed, scenario) or (seed, scenario, stage): the state depends
+        // only on the keys, so a scenario draws the same numbers whichever rank or thread processes it
+        template <typename... keys> static generator stream(std::uint64_t seed, keys... k) {
+            std::uint64_t state = seed;
+            ((state = splitmix64(state) ^ static_cast<std::uint64_t>(k)), ...);
+            return generator(splitmix64(state));
+        }
+
+        result_type operator()() {
+            const std::uint64_t result = rotl(s_[1] * 5, 7) * 9;
+            const std::uint64_t t = s_[1] << 17;
+            s_[2] ^= s_[0];
+            s_[3] ^= s_[1];
+            s_[1] ^= s_[2];
+            s_[0] ^= s_[3];
+            s_[2] ^= t;
+            s_[3] = rotl(s_[3], 45);
+            return result;
+        }
+
+        // advances the state by 2^128 draws, giving 2^128 non-overlapping subsequences
+        void jump() {
+            static constexpr std::uint64_t polynomial[] = { 0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa, 0x39abdc4529b1661c };
+            advance(polynomial);
+        }
+
+        // advances the state by 2^192 draws
+        void long_jump() {
+            static constexpr std::uint64_t polynomial[] = { 0x76e15d3efefdcbbf, 0xc5004e441c522fb3, 0x77710069854ee241, 0x39109bb02acbe635 };
+            advance(polynomial);
+        }
+
+        // uniform in [0, 1) with 53 random bits
+        double uniform() {
+            return static_cast<double>((*this)() >> 11) * 0x1.0p-53;
+        }
+
+        double uniform(double a, double b) {
+            return a + (b - a) * uniform();
+        }
+
+        // uniform integer in [0, n) without modulo bias: draws below 2^64 mod n are rejected. n must be positive
+        std::uint64_t below(std::uint64_t n) {
+            if (n == 0) { throw std::invalid_argument("owl::random::generator::below: n must be positive"); }
+            const std::uint64_t threshold = (0 - n) % n;
+            std::uint64_t x = (*this)();
+            while (x < threshold) { x = (*this)(); }
+            return x % n;
+        }
+
+        void fill_uniform(double* out, std::size_t n, double a = 0, double b = 1) {
+            for (std::size_t i = 0; i < n; ++i) { out[i] = a + (b - a) * uniform(); }
+        }
+
+        // Box-Muller: every pair of uniforms gives two normals, so the values depend only on the draw count
+        void fill_normal(double* out, std::size_t n, double mean = 0, double stddev = 1) {
+            std::size_t i = 0;
+            for (; i + 2 <= n; i += 2) {
+                double radius, angle;
+                polar(radius, angle);
+                out[i] = mean + stddev * radius * std::cos(angle);
+                out[i + 1] = mean + stddev * radius * std::sin(angle);
+            }
+            if (i < n) {
+                double radius, angle;
+                polar(radius, angle);
+                out[i] = mean + stddev * radius * std::cos(angle);
+            }
+        }
+
+        double normal(double mean = 0, double stddev = 1) {
+            double value;
+            fill_normal(&value, 1, mean, stddev);
+            return value;
+        }
+
+        void fill_uniform(std::vector<double>& v, double a = 0, double b = 1) {
+            fill_uniform(v.data(), v.size(), a, b);
+        }
+
+        void fill_normal(std::vector<double>& v, double mean = 0, double stddev = 1) {
+            fill_normal(v.data(), v.size(), mean, stddev);
+        }
+
+    private:
+        static std::uint64_t rotl(std::uint64_t x, int k) {
+            return (x << k) | (x >> (64 - k));
+        }
+
+        void polar(double& radius, double& angle) {
+            double u = 1.0 - uniform();
+            radius = std::sqrt(-2.0 * std::log(u));
+            angle = 2.0 * owl::constant::pi * uniform();
+        }
+
+        void advance(const std::uint64_t* polynomial) {
+            std::uint64_t s[4] = {};
+            for (int i = 0; i < 4; ++i) {
+                for (int b = 0; b < 64; ++b) {
+                    if (polynomial[i] & (std::uint64_t(1) << b)) {
+                        for (int k = 0; k < 4; ++k) { s[k] ^= s_[k]; }
+                    }
+                    (*this)();
+                }
+            }
+            for (int k = 0; k < 4; ++k) { s_[k] = s[k]; }
+        }
+
+        std::uint64_t s_[4];
+    };
+
+    template <typename... keys> inline generator stream(std::uint64_t seed, keys... k) {
+        return generator::stream(seed, k...);
+    }
+
+    // the calling thread's generator: the n-th thread to call local() gets the stream for (0, n), so a single-threaded
+    // program draws the same numbers on every run and no two threads repeat each other. Which worker becomes the n-th
+    // depends on scheduling, so threaded code that must be reproducible calls seed_local with its task or worker index
+    inline generator& local() {
+        static std::atomic<std::uint64_t> threads{ 0 };
+        thread_local generator instance = generator::stream(0, threads.fetch_add(1, std::memory_order_relaxed));
+        return instance;
+    }
+
+    // reseeds only the calling thread's generator with the stream for (seed, key). Threads that reseed must pass
+    // distinct keys, such as their task or worker index, or they all draw the same numbers
+    inline void seed_local(std::uint64_t seed, std::uint64_t key = 0) {
+        local() = generator::stream(seed, key);
+    }
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,410 @@
+#pragma once
+
+#ifndef OWL_SIMD_H
+#define OWL_SIMD_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define OWL_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define OWL_SIMD_X86 0
+#endif
+
+namespace owl::simd {
+    // every kernel keeps eight independent lanes (element i always goes to lane i % 8) and folds them in the same
+    // fixed order, so the scalar, AVX2 and AVX-512 paths produce bit-identical results
+    inline constexpr std::size_t lanes = 8;
+
+    // avx2 means AVX2 together with FMA, as on every AVX2 processor in practice
+    enum class isa { scalar, avx2, avx512 };
+
+    inline isa detect() {
+#if OWL_SIMD_X86
+        static const isa supported = [] {
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f")) { return isa::avx512; }
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) { return isa::avx2; }
+            return isa::scalar;
+        }();
+        return supported;
+#else
+        return isa::scalar;
+#endif
+    }
+
+    inline double fold_sum(const double* lane) {
+        return ((lane[0] + lane[1]) + (lane[2] + lane[3])) + ((lane[4] + lane[5]) + (lane[6] + lane[7]));
+    }
+
+    inline double fold_product(const double* lane) {
+        return ((lane[0] * lane[1]) * (lane[2] * lane[3])) * ((lane[4] * lane[5]) * (lane[6] * lane[7]));
+    }
+
+    inline double fold_minimum(const double* lane) {
+        double m = lane[0];
+        for (std::size_t j = 1; j < lanes; ++j) { m = lane[j] < m ? lane[j] : m; }
+        return m;
+    }
+
+    inline double fold_maximum(const double* lane) {
+        double m = lane[0];
+        for (std::size_t j = 1; j < lanes; ++j) { m = lane[j] > m ? lane[j] : m; }
+        return m;
+    }
+
+    enum class op { add, multiply, minimum, maximum };
+
+    template <op o> inline double apply(double acc, double x) {
+        if constexpr (o == op::add) { return acc + x; }
+        if constexpr (o == op::multiply) { return acc * x; }
+        if constexpr (o == op::minimum) { return x < acc ? x : acc; }
+        if constexpr (o == op::maximum) { return x > acc ? x : acc; }
+    }
+
+    template <op o> inline double fold(const double* lane) {
+        if constexpr (o == op::add) { return fold_sum(lane); }
+        if constexpr (o == op::multiply) { return fold_product(lane); }
+        if constexpr (o == op::minimum) { return fold_minimum(lane); }
+        if constexpr (o == op::maximum) { return fold_maximum(lane); }
+    }
+
+    template <op o> inline void initialize(const double* x, double* lane) {
+        for (std::size_t j = 0; j < lanes; ++j) {
+            lane[j] = o == op::add ? 0.0 : (o == op::multiply ? 1.0 : x[0]);
+        }
+    }
+
+    namespace scalar {
+        template <op o> inline double reduce(const double* x, std::size_t n) {
+            double lane[lanes];
+            initialize<o>(x, lane);
+            for (std::size_t i = 0; i < n; ++i) { lane[i % lanes] = apply<o>(lane[i % lanes], x[i]); }
+            return fold<o>(lane);
+        }
+    }
+
+#if OWL_SIMD_X86
+    namespace avx2 {
+        // _mm256_min_pd(a, b) returns a < b ? a : b, which matches the scalar lane update exactly
+        template <op o> __attribute__((target("avx2"))) inline __m256d apply(__m256d acc, __m256d x) {
+            if constexpr (o == op::add) { return _mm256_add_pd(acc, x); }
+            if constexpr (o == op::multiply) { return _mm256_mul_pd(acc, x); }
+            if constexpr (o == op::minimum) { return _mm256_min_pd(x, acc); }
+            if constexpr (o == op::maximum) { return _mm256_max_pd(x, acc); }
+        }
+
+        template <op o> __attribute__((target("avx2"))) inline double reduce(const double* x, std::size_t n) {
+            double lane[lanes];
+            initialize<o>(x, lane);
+
+            __m256d low = _mm256_loadu_pd(lane);
+            __m256d high = _mm256_loadu_pd(lane + 4);
+            std::size_t i = 0;
+            for (; i + lanes <= n; i += lanes) {
+                low = apply<o>(low, _mm256_loadu_pd(x + i));
+                high = apply<o>(high, _mm256_loadu_pd(x + i + 4));
+            }
+            _mm256_storeu_pd(lane, low);
+            _mm256_storeu_pd(lane + 4, high);
+
+            for (; i < n; ++i) { lane[i % lanes] = owl::simd::apply<o>(lane[i % lanes], x[i]); }
+            return fold<o>(lane);
+        }
+    }
+
+    namespace avx512 {
+        template <op o> __attribute__((target("avx512f"))) inline __m512d apply(__m512d acc, __m512d x) {
+            if constexpr (o == op::add) { return _mm512_add_pd(acc, x); }
+            if constexpr (o == op::multiply) { return _mm512_mul_pd(acc, x); }
+            if constexpr (o == op::minimum) { return _mm512_mask_min_pd(acc, 0xFF, x, acc); }
+            if constexpr (o == op::maximum) { return _mm512_mask_max_pd(acc, 0xFF, x, acc); }
+        }
+
+        template <op o> __attribute__((target("avx512f"))) inline double reduce(const double* x, std::size_t n) {
+            double lane[lanes];
+            initialize<o>(x, lane);
+
+            __m512d acc = _mm512_loadu_pd(lane);
+            std::size_t i = 0;
+            for (; i + lanes <= n; i += lanes) { acc = apply<o>(acc, _mm512_loadu_pd(x + i)); }
+            _mm512_storeu_pd(lane, acc);
+
+            for (; i < n; ++i) { lane[i % lanes] = owl::simd::apply<o>(lane[i % lanes], x[i]); }
+            return fold<o>(lane);
+        }
+    }
+#endif
+
+    template <op o> inline double reduce(const double* x, std::size_t n) {
+#if OWL_SIMD_X86
+        switch (detect()) {
+            case isa::avx512: return avx512::reduce<o>(x, n);
+            case isa::avx2: return avx2::reduce<o>(x, n);
+            default: break;
+        }
+#endif
+        return scalar::reduce<o>(x, n);
+    }
+
+    inline double sum(const double* x, std::size_t n) {
+        return reduce<op::add>(x, n);
+    }
+
+    inline double product(const double* x, std::size_t n) {
+        return reduce<op::multiply>(x, n);
+    }
+
+    // minimum and maximum expect n > 0
+    inline double minimum(const double* x, std::size_t n) {
+        return reduce<op::minimum>(x, n);
+    }
+
+    inline double maximum(const double* x, std::size_t n) {
+        return reduce<op::maximum>(x, n);
+    }
+
+    // Weighted sums for discounting. dot(x, w, n) adds x[i] * w[i] into lane i % 8. discounted_sum(x, n, seed, step)
+    // does the same with weights generated on the fly: lane j starts at seed[j] and is multiplied by step after every
+    // group of eight elements. geometric() writes out those same weights, so dot over them matches discounted_sum bit
+    // for bit. Every lane update is one fused multiply-add (std::fma in the scalar path), so floating-point contraction
+    // by the compiler cannot make the paths disagree
+    inline void geometric(const double* seed, double step, std::size_t n, double* out) {
+        double d[lanes];
+        for (std::size_t j = 0; j < lanes; ++j) { d[j] = seed[j]; }
+        for (std::size_t i = 0; i < n; i += lanes) {
+            for (std::size_t j = 0; j < lanes && i + j < n; ++j) {
+                out[i + j] = d[j];
+                d[j] *= step;
+            }
+        }
+    }
+
+    namespace scalar {
+        inline double dot(const double* x, const double* w, std::size_t n) {
+            double lane[lanes] = {};
+            for (std::size_t i = 0; i < n; ++i) { lane[i % lanes] = std::fma(x[i], w[i], lane[i % lanes]); }
+            return fold_sum(lane);
+        }
+
+        inline double discounted_sum(const double* x, std::size_t n, const double* seed, double step) {
+            double lane[lanes] = {}, d[lanes];
+            for (std::size_t j = 0; j < lanes; ++j) { d[j] = seed[j]; }
+            std::size_t i = 0;
+            for (; i + lanes <= n; i += lanes) {
+                for (std::size_t j = 0; j < lanes; ++j) {
+                    lane[j] = std::fma(x[i + j], d[j], lane[j]);
+                    d[j] *= step;
+                }
+            }
+            for (std::size_t j = 0; i + j < n; ++j) { lane[j] = std::fma(x[i + j], d[j], lane[j]); }
+            return fold_sum(lane);
+        }
+    }
+
+#if OWL_SIMD_X86
+    namespace avx2 {
+        __attribute__((target("avx2,fma"))) inline double dot(const double* x, const double* w, std::size_t n) {
+            double lane[lanes];
+            __m256d low = _mm256_setzero_pd(), high = _mm256_setzero_pd();
+            std::size_t i = 0;
+            for (; i + lanes <= n; i += lanes) {
+                low = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(w + i), low);
+                high = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(w + i + 4), high);
+            }
+            _mm256_storeu_pd(lane, low);
+            _mm256_storeu_pd(lane + 4, high);
+
+            for (; i < n; ++i) { lane[i % lanes] = std::fma(x[i], w[i], lane[i % lanes]); }
+            return fold_sum(lane);
+        }
+
+        __attribute__((target("avx2,fma"))) inline double discounted_sum(const double* x, std::size_t n, const double* seed, double step) {
+            double lane[lanes], d[lanes];
+            __m256d low = _mm256_setzero_pd(), high = _mm256_setzero_pd();
+            __m256d d_low = _mm256_loadu_pd(seed), d_high = _mm256_loadu_pd(seed + 4);
+            const __m256d factor = _mm256_set1_pd(step);
+            std::size_t i = 0;
+            for (; i + lanes <= n; i += lanes) {
+                low = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), d_low, low);
+                high = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4), d_high, high);
+                d_low = _mm256_mul_pd(d_low, factor);
+                d_high = _mm256_mul_pd(d_high, factor);
+            }
+            _mm256_storeu_pd(lane, low);
+            _mm256_storeu_pd(lane + 4, high);
+            _mm256_storeu_pd(d, d_low);
+            _mm256_storeu_pd(d + 4, d_high);
+
+            for (std::size_t j = 0; i + j < n; ++j) { lane[j] = std::fma(x[i + j], d[j], lane[j]); }
+            return fold_sum(lane);
+        }
+    }
+
+    namespace avx512 {
+        __attribute__((target("avx512f"))) inline double dot(const double* x, const double* w, std::size_t n) {
+            double lane[lanes];
+            __m512d acc = _mm512_setzero_pd();
+            std::size_t i = 0;
+            for (; i + lanes <= n; i += lanes) { acc = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(w + i), acc); }
+            _mm512_storeu_pd(lane, acc);
+
+            for (; i < n; ++i) { lane[i % lanes] = std::fma(x[i], w[i], lane[i % lanes]); }
+            return fold_sum(lane);
+        }
+
+        __attribute__((target("avx512f"))) inline double discounted_sum(const double* x, std::size_t n, const double* seed, double step) {
+            double lane[lanes], d[lanes];
+            __m512d acc = _mm512_setzero_pd();
+            __m512d weights = _mm512_loadu_pd(seed);
+            const __m512d factor = _mm512_set1_pd(step);
+            std::size_t i = 0;
+            for (; i + lanes <= n; i += lanes) {
+                acc = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), weights, acc);
+                weights = _mm512_mul_pd(weights, factor);
+            }
+            _mm512_storeu_pd(lane, acc);
+            _mm512_storeu_pd(d, weights);
+
+            for (std::size_t j = 0; i + j < n; ++j) { lane[j] = std::fma(x[i + j], d[j], lane[j]); }
+            return fold_sum(lane);
+        }
+    }
+#endif
+
+    inline double dot(const double* x, const double* w, std::size_t n) {
+#if OWL_SIMD_X86
+        switch (detect()) {
+            case isa::avx512: return avx512::dot(x, w, n);
+            case isa::avx2: return avx2::dot(x, w, n);
+            default: break;
+        }
+#endif
+        return scalar::dot(x, w, n);
+    }
+
+    inline double discounted_sum(const double* x, std::size_t n, const double* seed, double step) {
+#if OWL_SIMD_X86
+        switch (detect()) {
+            case isa::avx512: return avx512::discounted_sum(x, n, seed, step);
+            case isa::avx2: return avx2::discounted_sum(x, n, seed, step);
+            default: break;
+        }
+#endif
+        return scalar::discounted_sum(x, n, seed, step);
+    }
+
+    // |a - b| <= max(atol, rtol * max(|a|, |b|)) for finite values, or a == b; same test as owl::math::approximately_equal
+    inline bool approximately_equal(double a, double b, double rtol, double atol) {
+        return a == b || (std::isfinite(a) && std::isfinite(b) && std::abs(a - b) <= (std::max)(atol, rtol * (std::max)(std::abs(a), std::abs(b))));
+    }
+
+    namespace scalar {
+        inline void approximately_equal(const double* a, const double* b, std::size_t n, double rtol, double atol, std::uint64_t* words) {
+            for (std::size_t w = 0; w * 64 < n; ++w) {
+                std::uint64_t word = 0;
+                for (std::size_t j = 0, count = (std::min)(n - w * 64, (std::size_t)64); j < count; ++j) {
+                    word |= static_cast<std::uint64_t>(owl::simd::approximately_equal(a[w * 64 + j], b[w * 64 + j], rtol, atol)) << j;
+                }
+                words[w] = word;
+            }
+        }
+    }
+
+#if OWL_SIMD_X86
+    namespace avx2 {
+        __attribute__((target("avx2"))) inline void approximately_equal(const double* a, const double* b, std::size_t n, double rtol, double atol, std::uint64_t* words) {
+            const __m256d sign = _mm256_set1_pd(-0.0);
+            const __m256d largest = _mm256_set1_pd(1.7976931348623157e308);
+            const __m256d relative = _mm256_set1_pd(rtol);
+            const __m256d absolute = _mm256_set1_pd(atol);
+
+            std::size_t full = n / 64;
+            for (std::size_t w = 0; w < full; ++w) {
+                std::uint64_t word = 0;
+                for (std::size_t j = 0; j < 64; j += 4) {
+                    __m256d x = _mm256_loadu_pd(a + w * 64 + j);
+                    __m256d y = _mm256_loadu_pd(b + w * 64 + j);
+                    __m256d ax = _mm256_andnot_pd(sign, x);
+                    __m256d ay = _mm256_andnot_pd(sign, y);
+                    __m256d finite = _mm256_and_pd(_mm256_cmp_pd(ax, largest, _CMP_LE_OQ), _mm256_cmp_pd(ay, largest, _CMP_LE_OQ));
+                    __m256d tolerance = _mm256_max_pd(_mm256_mul_pd(relative, _mm256_max_pd(ax, ay)), absolute);
+                    __m256d close = _mm256_cmp_pd(_mm256_andnot_pd(sign, _mm256_sub_pd(x, y)), tolerance, _CMP_LE_OQ);
+                    __m256d equal = _mm256_or_pd(_mm256_cmp_pd(x, y, _CMP_EQ_OQ), _mm256_and_pd(finite, close));
+                    word |= static_cast<std::uint64_t>(_mm256_movemask_pd(equal)) << j;
+                }
+                words[w] = word;
+            }
+            if (full * 64 < n) { scalar::approximately_equal(a + full * 64, b + full * 64, n - full * 64, rtol, atol, words + full); }
+        }
+    }
+#endif
+
+    // writes one bit per element into words[0, ceil(n / 64)), element i at bit i % 64 of word i / 64; unused high bits
+    // of the last word are zero
+    inline void approximately_equal(const double* a, const double* b, std::size_t n, double rtol, double atol, std::uint64_t* words) {
+#if OWL_SIMD_X86
+        if (detect() != isa::scalar) {
+            avx2::approximately_equal(a, b, n, rtol, atol, words);
+            return;
+        }
+#endif
+        scalar::approximately_equal(a, b, n, rtol, atol, words);
+    }
+
+    // table[clamp(x * factor + offset, 0, last)] with the position truncated toward zero and NaN sent to entry 0, as
+    // owl::color::gradient looks up its colors. The position is one fused multiply-add in every path, so the scalar
+    // and AVX2 lookups pick the same entry
+    inline std::size_t table_index(double x, double factor, double offset, double last) {
+        double t = std::fma(x, factor, offset);
+        t = t > 0 ? t : 0;
+        t = t < last ? t : last;
+        return static_cast<std::size_t>(t);
+    }
+
+    namespace scalar {
+        inline void lookup(const double* x, std::size_t n, double factor, double offset, double last, const std::uint32_t* table, std::uint32_t* out) {
+            for (std::size_t i = 0; i < n; ++i) { out[i] = table[table_index(x[i], factor, offset, last)]; }
+        }
+    }
+
+#if OWL_SIMD_X86
+    namespace avx2 {
+        // _mm256_max_pd(t, 0) returns its second operand when t is NaN, matching the scalar clamp
+        __attribute__((target("avx2,fma"))) inline void lookup(const double* x, std::size_t n, double factor, double offset, double last, const std::uint32_t* table, std::uint32_t* out) {
+            const __m256d scale = _mm256_set1_pd(factor);
+            const __m256d shift = _mm256_set1_pd(offset);
+            const __m256d zero = _mm256_setzero_pd();
+            const __m256d upper = _mm256_set1_pd(last);
+            const int* entries = reinterpret_cast<const int*>(table);
+
+            std::size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                __m256d low = _mm256_min_pd(_mm256_max_pd(_mm256_fmadd_pd(_mm256_loadu_pd(x + i), scale, shift), zero), upper);
+                __m256d high = _mm256_min_pd(_mm256_max_pd(_mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4), scale, shift), zero), upper);
+                __m256i index = _mm256_set_m128i(_mm256_cvttpd_epi32(high), _mm256_cvttpd_epi32(low));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_i32gather_epi32(entries, index, 4));
+            }
+            scalar::lookup(x + i, n - i, factor, offset, last, table, out + i);
+        }
+    }
+#endif
+
+    // out[i] = table[table_index(x[i], factor, offset, last)] for i in [0, n); table holds last + 1 entries
+    inline void lookup(const double* x, std::size_t n, double factor, double offset, double last, const std::uint32_t* table, std::uint32_t* out) {
+#if OWL_SIMD_X86
+        // the AVX2 gather takes 32-bit indices
+        if (detect() != isa::scalar && last < 2147483648.0) {
+            avx2::lookup(x, n, factor, offset, last, table, out);
+            return;
+        }
+#endif
+        scalar::lookup(x, n, factor, offset, last, table, out);
+    }
+}
+
+#endif
\ No newline at end of file
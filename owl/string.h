@@ -4,16 +4,40 @@
 #define OWL_STRING_H
 
 #include <algorithm>
+#include <cerrno>
+#include <charconv>
 #include <memory>
+#include <memory_resource>
 #include <numeric>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
 #include <cstring>
 #include <sstream>
 #include <unordered_set>
 #include <vector>
 #include <random>
-#include <codecvt>
-#include <locale>
+#include <cstdint>
+#include <cwchar>
+
+#include <owl/random.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OWL_STRING_SSE2 1
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#else
+#define OWL_STRING_SSE2 0
+#endif
 
 namespace std {
     inline std::string to_string(std::string s) {
@@ -22,16 +46,21 @@ namespace std {
 }
 
 namespace owl::string {
-    inline std::string random_string(int n = 16) {
+    inline std::string random_string(int n, owl::random::generator& generator) {
         const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
-        const size_t length = std::strlen(alphabet);
-        auto generator = [&]() { return alphabet[std::rand() % length]; };
-        std::string s;
-        s.reserve(n);
-        std::generate_n(back_inserter(s), n, generator);
+        const std::uint64_t length = std::strlen(alphabet);
+        std::string s(n, ' ');
+        for (auto& c : s) { c = alphabet[generator.below(length)]; }
         return s;
     }
 
+    // draws from the calling thread's generator, so concurrent calls neither lock nor repeat each other. Like the
+    // std::rand version it replaces, a single-threaded program gets the same strings on every run; threads call
+    // owl::random::seed_local, or pass a generator such as owl::random::stream(seed, key), to fix their sequence
+    inline std::string random_string(int n = 16) {
+        return random_string(n, owl::random::local());
+    }
+
     inline std::string remove_suffix(std::string s, int n) {
         return s.substr(0, s.length() - n);
     }
@@ -62,6 +91,13 @@ namespace owl::string {
         return s;
     }
 
+    inline std::string_view trim_view(std::string_view s) {
+        std::size_t first = 0, last = s.size();
+        while (first < last && std::isspace(static_cast<unsigned char>(s[first]))) { ++first; }
+        while (last > first && std::isspace(static_cast<unsigned char>(s[last - 1]))) { --last; }
+        return s.substr(first, last - first);
+    }
+
     inline bool has_ending(std::string const& s, std::string const& ending) {
         if (s.length() >= ending.length()) {
             return (0 == s.compare(s.length() - ending.length(), ending.length(), ending));
@@ -70,70 +106,399 @@ namespace owl::string {
         }
     }
 
+    // position of the first c in s at or after from, or npos; scans 16 bytes per step on SSE2 targets
+    inline std::size_t find(std::string_view s, char c, std::size_t from = 0) {
+        const char* data = s.data();
+        std::size_t size = s.size(), i = from;
+#if OWL_STRING_SSE2
+        const __m128i needle = _mm_set1_epi8(c);
+        for (; i + 16 <= size; i += 16) {
+            int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), needle));
+            if (mask != 0) {
+#ifdef _MSC_VER
+                unsigned long bit;
+                _BitScanForward(&bit, static_cast<unsigned long>(mask));
+                return i + bit;
+#else
+                return i + __builtin_ctz(static_cast<unsigned int>(mask));
+#endif
+            }
+        }
+#endif
+        for (; i < size; ++i) {
+            if (data[i] == c) { return i; }
+        }
+        return std::string_view::npos;
+    }
+
+    // calls f(token) for every trimmed token of s, with the same tokens split(s, delimiter) produces, without allocating
+    template <typename function> inline void for_each_token(std::string_view s, char delimiter, function f) {
+        std::size_t start = 0, size = s.size();
+        while (start < size) {
+            std::size_t end = owl::string::find(s, delimiter, start);
+            if (end == std::string_view::npos) {
+                f(trim_view(s.substr(start)));
+                return;
+            }
+            f(trim_view(s.substr(start, end - start)));
+            start = end + 1;
+        }
+    }
+
+    // tokens of s separated by any character of delimiters, skipping empty tokens, as split(s, delimiters) does
+    template <typename function> inline void for_each_token(std::string_view s, std::string_view delimiters, function f) {
+        std::size_t start = s.find_first_not_of(delimiters);
+        while (start != std::string_view::npos) {
+            std::size_t end = s.find_first_of(delimiters, start);
+            f(s.substr(start, end == std::string_view::npos ? std::string_view::npos : end - start));
+            start = end == std::string_view::npos ? end : s.find_first_not_of(delimiters, end);
+        }
+    }
+
+    // the views point into s, which must outlive them; tokens is cleared first so one buffer can be reused across lines
+    inline void split_view(std::string_view s, char delimiter, std::vector<std::string_view>& tokens) {
+        tokens.clear();
+        for_each_token(s, delimiter, [&tokens](std::string_view token) { tokens.push_back(token); });
+    }
+
+    inline void split_view(std::string_view s, std::string_view delimiters, std::vector<std::string_view>& tokens) {
+        tokens.clear();
+        for_each_token(s, delimiters, [&tokens](std::string_view token) { tokens.push_back(token); });
+    }
+
+    inline std::vector<std::string_view> split_view(std::string_view s, char delimiter = ',') {
+        std::vector<std::string_view> tokens;
+        split_view(s, delimiter, tokens);
+        return tokens;
+    }
+
+    inline std::vector<std::string_view> split_view(std::string_view s, std::string_view delimiters) {
+        std::vector<std::string_view> tokens;
+        split_view(s, delimiters, tokens);
+        return tokens;
+    }
+
     inline std::vector<std::string> split(const std::string& s, char delimiter = ',') {
         std::vector<std::string> tokens;
-        std::string token;
-
-        std::istringstream stream(s);
-        while (std::getline(stream, token, delimiter)) { tokens.push_back(trim(token)); }
+        for_each_token(s, delimiter, [&tokens](std::string_view token) { tokens.emplace_back(token); });
         return tokens;
     }
 
     inline std::vector<std::string> split(const std::string& s, const std::string& delimiter = ",") {
         std::vector<std::string> tokens;
-        std::size_t start = s.find_first_not_of(delimiter);
-        std::size_t end = 0;
+        for_each_token(s, std::string_view(delimiter), [&tokens](std::string_view token) { tokens.emplace_back(token); });
+        return tokens;
+    }
+
+    inline std::pmr::vector<std::pmr::string> split(const std::string& s, char delimiter, std::pmr::memory_resource* resource) {
+        std::pmr::vector<std::pmr::string> tokens(resource);
+        for_each_token(s, delimiter, [&tokens](std::string_view token) { tokens.emplace_back(token); });
+        return tokens;
+    }
+
+    inline std::pmr::vector<std::pmr::string> split(const std::string& s, const std::string& delimiter, std::pmr::memory_resource* resource) {
+        std::pmr::vector<std::pmr::string> tokens(resource);
+        for_each_token(s, std::string_view(delimiter), [&tokens](std::string_view token) { tokens.emplace_back(token); });
+        return tokens;
+    }
 
-        while ((end = s.find_first_of(delimiter, start)) != std::string::npos) {
-            tokens.push_back(s.substr(start, end - start));
-            start = s.find_first_not_of(delimiter, end);
+    // append-only output buffer: numbers are formatted with std::to_chars straight into the buffer, and a builder bound
+    // to a stream or file descriptor hands its contents over in chunks instead of growing without bound
+    class builder {
+    public:
+        builder() = default;
+
+        explicit builder(std::size_t capacity) {
+            buffer_.reserve(capacity);
         }
 
-        if (start != std::string::npos) {
-            tokens.push_back(s.substr(start));
+        explicit builder(std::ostream& stream, std::size_t chunk = 1 << 16) : stream_(&stream), chunk_(chunk) {
+            buffer_.reserve(chunk + 512);
         }
 
-        return tokens;
-    }
+        builder(int fd, std::size_t chunk) : fd_(fd), chunk_(chunk) {
+            buffer_.reserve(chunk + 512);
+        }
+
+        builder(const builder&) = delete;
+        builder& operator=(const builder&) = delete;
+
+        // flushes what is left; errors cannot propagate from here, so call flush() first when they matter
+        ~builder() {
+            try {
+                flush();
+            } catch (...) {
+            }
+        }
+
+        builder& append(std::string_view s) {
+            buffer_.append(s.data(), s.size());
+            return spill();
+        }
+
+        builder& append(char c) {
+            buffer_.push_back(c);
+            return spill();
+        }
+
+        // formats value as std::to_string would
+        template <typename T> builder& append(const T& value) {
+            if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+                return append(std::string_view(value));
+            } else if constexpr (std::is_same_v<T, bool>) {
+                return append(value ? '1' : '0');
+            } else if constexpr (std::is_integral_v<T>) {
+                char digits[24];
+                return append(std::string_view(digits, std::to_chars(digits, digits + sizeof digits, value).ptr - digits));
+            } else if constexpr (std::is_floating_point_v<T>) {
+                return append_fixed(value, 6);
+            } else {
+                return append(std::to_string(value));
+            }
+        }
+
+        // formats value exactly as std::to_string would: character types print their code, not the character
+        template <typename T> builder& append_number(const T& value) {
+            if constexpr (std::is_integral_v<T>) {
+                return append(+value);
+            } else {
+                return append(value);
+            }
+        }
+
+        // the fast paths format into a stack buffer; values too long for it (huge magnitudes in fixed notation, or a
+        // high precision) fall back to an ostringstream with the same notation
+        template <typename T> builder& append_fixed(T value, int precision) {
+            char digits[512];
+            auto result = std::to_chars(digits, digits + sizeof digits, value, std::chars_format::fixed, precision);
+            if (result.ec != std::errc()) { return append_stream(value, std::ios_base::fixed, precision); }
+            return append(std::string_view(digits, result.ptr - digits));
+        }
+
+        // formats value as to_string_with_precision would (std::scientific with the given precision)
+        template <typename T> builder& append_scientific(T value, int precision = 6) {
+            if constexpr (std::is_floating_point_v<T>) {
+                char digits[128];
+                auto result = std::to_chars(digits, digits + sizeof digits, value, std::chars_format::scientific, precision);
+                if (result.ec != std::errc()) { return append_stream(value, std::ios_base::scientific, precision); }
+                return append(std::string_view(digits, result.ptr - digits));
+            } else {
+                return append(value);
+            }
+        }
+
+        template <typename T> builder& operator<<(const T& value) {
+            return append(value);
+        }
+
+        const std::string& str() const { return buffer_; }
+        std::string_view view() const { return buffer_; }
+        std::size_t size() const { return buffer_.size(); }
+        bool empty() const { return buffer_.empty(); }
+
+        std::string release() {
+            std::string s = std::move(buffer_);
+            buffer_.clear();
+            return s;
+        }
+
+        void reserve(std::size_t capacity) { buffer_.reserve(capacity); }
+        void clear() { buffer_.clear(); }
+
+        // hands the buffered bytes to the stream or file descriptor; a no-op for builders without a sink. A failed write
+        // throws std::system_error and keeps the bytes not yet written in the buffer
+        void flush() {
+            if (buffer_.empty()) { return; }
+            if (stream_ != nullptr) {
+                stream_->write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+                buffer_.clear();
+            } else if (fd_ >= 0) {
+                std::size_t written = 0;
+                while (written < buffer_.size()) {
+#ifdef _WIN32
+                    auto n = ::_write(fd_, buffer_.data() + written, static_cast<unsigned int>(buffer_.size() - written));
+#else
+                    auto n = ::write(fd_, buffer_.data() + written, buffer_.size() - written);
+#endif
+                    if (n < 0 && errno == EINTR) { continue; }
+                    if (n <= 0) {
+                        int error = n < 0 ? errno : EIO;
+                        buffer_.erase(0, written);
+                        throw std::system_error(error, std::generic_category(), "owl::string::builder::flush");
+                    }
+                    written += static_cast<std::size_t>(n);
+                }
+                buffer_.clear();
+            }
+        }
+
+    private:
+        template <typename T> builder& append_stream(T value, std::ios_base::fmtflags format, int precision) {
+            std::ostringstream out;
+            out.precision(precision);
+            out.setf(format, std::ios_base::floatfield);
+            out << value;
+            return append(out.str());
+        }
+
+        builder& spill() {
+            if (chunk_ > 0 && buffer_.size() >= chunk_) { flush(); }
+            return *this;
+        }
+
+        std::string buffer_;
+        std::ostream* stream_ = nullptr;
+        int fd_ = -1;
+        std::size_t chunk_ = 0;
+    };
 
     template <typename T> inline std::string to_string_with_precision(const T v, const int n = 6) {
-        std::ostringstream out;
-        out.precision(n);
-        out << std::scientific << v;
-        return out.str();
+        builder b;
+        b.append_scientific(v, n);
+        return b.release();
     }
 
-    template <typename T> inline std::string join(std::unordered_set<T> v, std::string delimiter = ", ") {
-        return std::accumulate(std::begin(v), std::end(v), std::string(), [delimiter](std::string& ss, T p) { return ss.empty() ? std::to_string(p) : ss + delimiter + std::to_string(p); });
+    template <typename container> inline std::string join_container(const container& v, const std::string& prefix, const std::string& delimiter, bool scientific) {
+        builder b(v.size() * (prefix.size() + delimiter.size() + (scientific ? 13 : 8)));
+        bool first = true;
+        for (const auto& p : v) {
+            if (!first) { b.append(delimiter); }
+            first = false;
+            b.append(prefix);
+            if (scientific) { b.append_scientific(p); } else { b.append_number(p); }
+        }
+        return b.release();
     }
 
-    template <typename T> inline std::string join(std::vector<T> v, std::string delimiter = ", ") {
-        return std::accumulate(std::begin(v), std::end(v), std::string(), [delimiter](std::string& ss, T p) { return ss.empty() ? std::to_string(p) : ss + delimiter + std::to_string(p); });
+    template <typename T> inline std::string join(const std::unordered_set<T>& v, std::string delimiter = ", ") {
+        return join_container(v, std::string(), delimiter, false);
     }
 
-    template <typename T> inline std::string join_with_precision(std::vector<T> v, std::string delimiter = ", ") {
-        return std::accumulate(std::begin(v), std::end(v), std::string(), [delimiter](std::string& ss, T p) { return ss.empty() ? owl::string::to_string_with_precision(p) : ss + delimiter + owl::string::to_string_with_precision(p); });
+    template <typename T> inline std::string join(const std::vector<T>& v, std::string delimiter = ", ") {
+        return join_container(v, std::string(), delimiter, false);
     }
-    
-    template <typename T> inline std::string join_with_prefix(std::vector<T> v, std::string prefix, std::string delimiter = ", ") {
-        return std::accumulate(std::begin(v), std::end(v), std::string(), [prefix, delimiter](std::string& ss, T p) { return ss.empty() ? (prefix + std::to_string(p)) : ss + delimiter + prefix + std::to_string(p); });
+
+    template <typename T> inline std::string join_with_precision(const std::vector<T>& v, std::string delimiter = ", ") {
+        return join_container(v, std::string(), delimiter, true);
     }
 
-    inline std::string ansi_to_utf8(const std::string& s) {
-        std::wstring wstr;
+    template <typename T> inline std::string join_with_prefix(const std::vector<T>& v, std::string prefix, std::string delimiter = ", ") {
+        return join_container(v, prefix, delimiter, false);
+    }
+
+    // true when every byte of s is below 0x80; checks 16 bytes per step on SSE2 targets, 8 otherwise
+    inline bool is_ascii(std::string_view s) {
+        const char* data = s.data();
+        std::size_t size = s.size(), i = 0;
+#if OWL_STRING_SSE2
+        __m128i any = _mm_setzero_si128();
+        for (; i + 16 <= size; i += 16) { any = _mm_or_si128(any, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i))); }
+        if (_mm_movemask_epi8(any) != 0) { return false; }
+#endif
+        std::uint64_t high = 0;
+        for (; i + 8 <= size; i += 8) {
+            std::uint64_t word;
+            std::memcpy(&word, data + i, 8);
+            high |= word;
+        }
+        for (; i < size; ++i) { high |= static_cast<unsigned char>(data[i]); }
+        return (high & 0x8080808080808080ull) == 0;
+    }
+
+    // writes the UTF-8 encoding of code point c to out (up to 4 bytes) and returns the byte count
+    inline std::size_t encode_utf8(char32_t c, char* out) {
+        if (c < 0x80) {
+            out[0] = static_cast<char>(c);
+            return 1;
+        }
+        if (c < 0x800) {
+            out[0] = static_cast<char>(0xC0 | (c >> 6));
+            out[1] = static_cast<char>(0x80 | (c & 0x3F));
+            return 2;
+        }
+        if (c < 0x10000) {
+            out[0] = static_cast<char>(0xE0 | (c >> 12));
+            out[1] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            out[2] = static_cast<char>(0x80 | (c & 0x3F));
+            return 3;
+        }
+        out[0] = static_cast<char>(0xF0 | (c >> 18));
+        out[1] = static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+        out[2] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+        out[3] = static_cast<char>(0x80 | (c & 0x3F));
+        return 4;
+    }
+
+    // Latin-1 (ISO-8859-1) to UTF-8 into out, which needs room for 2 * s.size() bytes; returns the bytes written
+    inline std::size_t latin1_to_utf8(std::string_view s, char* out) {
+        std::size_t n = 0;
+        for (char c : s) {
+            auto byte = static_cast<unsigned char>(c);
+            if (byte < 0x80) {
+                out[n++] = c;
+            } else {
+                out[n++] = static_cast<char>(0xC0 | (byte >> 6));
+                out[n++] = static_cast<char>(0x80 | (byte & 0x3F));
+            }
+        }
+        return n;
+    }
+
+    inline std::string latin1_to_utf8(std::string_view s) {
+        std::string out(2 * s.size(), '\0');
+        out.resize(latin1_to_utf8(s, out.data()));
+        return out;
+    }
+
+    // converts s from the multibyte encoding of the current C locale (the ANSI code page on Windows) into out, reusing
+    // its capacity; ASCII input is copied as is. Bytes the locale cannot decode, as in the default "C" locale, are read
+    // as Latin-1
+    inline void ansi_to_utf8(std::string_view s, std::string& out) {
+        if (is_ascii(s)) {
+            out.assign(s.data(), s.size());
+            return;
+        }
+
+        out.resize(4 * s.size());
+        std::size_t n = 0;
         std::mbstate_t state = {};
-        const char* src = s.data();
-        size_t len = std::mbsrtowcs(nullptr, &src, 0, &state);
-        if (static_cast<size_t>(-1) != len) {
-            std::unique_ptr< wchar_t[] > buff(new wchar_t[len + 1]);
-            len = std::mbsrtowcs(buff.get(), &src, len, &state);
-            if (static_cast<size_t>(-1) != len) {
-                wstr.assign(buff.get(), len);
+        for (std::size_t i = 0; i < s.size();) {
+            auto byte = static_cast<unsigned char>(s[i]);
+            if (byte < 0x80) {
+                out[n++] = s[i++];
+                continue;
+            }
+
+            wchar_t c;
+            std::size_t length = std::mbrtowc(&c, s.data() + i, s.size() - i, &state);
+            if (length == 0 || length > s.size() - i) {
+                state = {};
+                n += encode_utf8(byte, out.data() + n);
+                ++i;
+            } else {
+                n += encode_utf8(static_cast<char32_t>(c), out.data() + n);
+                i += length;
             }
         }
+        out.resize(n);
+    }
+
+    inline std::string ansi_to_utf8(const std::string& s) {
+        if (is_ascii(s)) { return s; }
 
-        std::wstring_convert<std::codecvt_utf8<wchar_t>> wcv;
-        return wcv.to_bytes(wstr);
+        std::string out;
+        ansi_to_utf8(s, out);
+        return out;
+    }
+
+    // converts every name in place; pure-ASCII names, the common case, are only scanned
+    inline void ansi_to_utf8(std::vector<std::string>& names) {
+        std::string buffer;
+        for (auto& name : names) {
+            if (is_ascii(name)) { continue; }
+            ansi_to_utf8(name, buffer);
+            name.swap(buffer);
+        }
     }
 }
 
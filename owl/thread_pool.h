@@ -0,0 +1,159 @@
+#pragma once
+
+#ifndef OWL_THREAD_POOL_H
+#define OWL_THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace owl::parallel {
+    // work-stealing pool: every worker pops from the back of its own queue and steals from the front of the others.
+    // The thread calling parallel_for also executes chunks while it waits, so nested calls cannot deadlock
+    class thread_pool {
+    public:
+        explicit thread_pool(std::size_t workers = (std::max)(std::thread::hardware_concurrency(), 1u) - 1) {
+            for (std::size_t i = 0; i < (std::max)(workers, (std::size_t)1); ++i) { queues_.push_back(std::make_unique<queue>()); }
+            for (std::size_t i = 0; i < workers; ++i) { threads_.emplace_back([this, i] { work(i); }); }
+        }
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        ~thread_pool() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stop_ = true;
+            }
+            wake_.notify_all();
+            for (auto& thread : threads_) { thread.join(); }
+        }
+
+        // number of threads that execute work, counting the caller of parallel_for
+        std::size_t concurrency() const { return threads_.size() + 1; }
+
+        // calls f(i) for every i in [first, last), in chunks of grain indices (by default four chunks per thread)
+        template <typename function> void parallel_for(std::size_t first, std::size_t last, function f, std::size_t grain = 0) {
+            if (first >= last) { return; }
+
+            std::size_t count = last - first;
+            if (grain == 0) { grain = (std::max)(count / (4 * concurrency()), (std::size_t)1); }
+            if (threads_.empty() || count <= grain) {
+                for (std::size_t i = first; i < last; ++i) { f(i); }
+                return;
+            }
+
+            std::size_t chunks = (count + grain - 1) / grain;
+            std::atomic<std::size_t> remaining(chunks);
+            std::mutex done_mutex;
+            std::condition_variable done;
+            std::exception_ptr error;
+
+            for (std::size_t c = 0; c < chunks; ++c) {
+                std::size_t a = first + c * grain, b = (std::min)(last, a + grain);
+                submit(c % queues_.size(), [&, a, b] {
+                    try {
+                        for (std::size_t i = a; i < b; ++i) { f(i); }
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(done_mutex);
+                        if (!error) { error = std::current_exception(); }
+                    }
+                    std::lock_guard<std::mutex> lock(done_mutex);
+                    if (--remaining == 0) { done.notify_all(); }
+                });
+            }
+
+            std::function<void()> task;
+            while (remaining > 0) {
+                if (pop(next_++ % queues_.size(), task)) {
+                    task();
+                } else {
+                    std::unique_lock<std::mutex> lock(done_mutex);
+                    done.wait(lock, [&remaining] { return remaining == 0; });
+                }
+            }
+
+            // the last chunk may still be releasing done_mutex, which must happen before it goes out of scope
+            std::lock_guard<std::mutex> lock(done_mutex);
+            if (error) { std::rethrow_exception(error); }
+        }
+
+    private:
+        struct queue {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        void submit(std::size_t index, std::function<void()> task) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ++pending_;
+            }
+            {
+                std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+                queues_[index]->tasks.push_back(std::move(task));
+            }
+            wake_.notify_one();
+        }
+
+        bool pop(std::size_t self, std::function<void()>& task) {
+            for (std::size_t k = 0, n = queues_.size(); k < n; ++k) {
+                auto& q = *queues_[(self + k) % n];
+                std::lock_guard<std::mutex> lock(q.mutex);
+                if (q.tasks.empty()) { continue; }
+
+                if (k == 0) {
+                    task = std::move(q.tasks.back());
+                    q.tasks.pop_back();
+                } else {
+                    task = std::move(q.tasks.front());
+                    q.tasks.pop_front();
+                }
+                --pending_;
+                return true;
+            }
+            return false;
+        }
+
+        void work(std::size_t self) {
+            std::function<void()> task;
+            while (true) {
+                if (pop(self, task)) {
+                    task();
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [this] { return stop_ || pending_ > 0; });
+                if (stop_ && pending_ == 0) { return; }
+            }
+        }
+
+        std::vector<std::unique_ptr<queue>> queues_;
+        std::vector<std::thread> threads_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::atomic<std::size_t> pending_{ 0 };
+        std::atomic<std::size_t> next_{ 0 };
+        bool stop_ = false;
+    };
+
+    inline thread_pool& default_pool() {
+        static thread_pool pool;
+        return pool;
+    }
+
+    template <typename function> inline void parallel_for(std::size_t first, std::size_t last, function f, std::size_t grain = 0) {
+        default_pool().parallel_for(first, last, f, grain);
+    }
+}
+
+#endif
\ No newline at end of file
@@ -4,28 +4,174 @@
 #define OWL_VECTOR_H
 
 #include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory_resource>
+#include <type_traits>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
+#include <owl/hash.h>
+
 namespace owl::vector {
-    template <typename type> inline void remove_duplicates(std::vector<type>& v) {
-        std::unordered_set<type> seen;
+    // sorted, duplicate-free values in one contiguous vector: lookups are binary searches, set operations are linear
+    // merges, and bulk construction sorts once. Single insertions and erasures shift the tail, so build in bulk
+    template <typename type, typename compare = std::less<type>> class flat_set {
+    public:
+        using value_type = type;
+        using const_iterator = typename std::vector<type>::const_iterator;
+        using iterator = const_iterator;
 
-        auto new_end = std::remove_if(v.begin(), v.end(), [&seen](const type& value) {
-            if (seen.find(value) != std::end(seen)) {
-                return true;
-            }
+        flat_set() = default;
+
+        explicit flat_set(std::vector<type> values) : values_(std::move(values)) {
+            normalize();
+        }
+
+        flat_set(std::initializer_list<type> values) : values_(values) {
+            normalize();
+        }
+
+        template <typename input_iterator> flat_set(input_iterator first, input_iterator last) : values_(first, last) {
+            normalize();
+        }
+
+        std::size_t size() const { return values_.size(); }
+        bool empty() const { return values_.empty(); }
+
+        const_iterator begin() const { return values_.begin(); }
+        const_iterator end() const { return values_.end(); }
+
+        const type* data() const { return values_.data(); }
+        const std::vector<type>& values() const { return values_; }
+
+        const type& operator[](std::size_t i) const { return values_[i]; }
+
+        void reserve(std::size_t n) { values_.reserve(n); }
+        void clear() { values_.clear(); }
+
+        const_iterator lower_bound(const type& value) const {
+            return std::lower_bound(values_.begin(), values_.end(), value, compare());
+        }
+
+        const_iterator find(const type& value) const {
+            auto it = lower_bound(value);
+            return it != values_.end() && !compare()(value, *it) ? it : values_.end();
+        }
+
+        bool contains(const type& value) const { return find(value) != values_.end(); }
+        std::size_t count(const type& value) const { return contains(value) ? 1 : 0; }
+
+        std::pair<const_iterator, bool> insert(const type& value) {
+            auto it = lower_bound(value);
+            if (it != values_.end() && !compare()(value, *it)) { return std::make_pair(it, false); }
+            return std::make_pair(values_.insert(it, value), true);
+        }
+
+        // adds many values with one sort and one merge instead of a shift per value
+        template <typename input_iterator> void insert(input_iterator first, input_iterator last) {
+            std::size_t middle = values_.size();
+            values_.insert(values_.end(), first, last);
+            std::sort(values_.begin() + middle, values_.end(), compare());
+            std::inplace_merge(values_.begin(), values_.begin() + middle, values_.end(), compare());
+            unique();
+        }
+
+        std::size_t erase(const type& value) {
+            auto it = find(value);
+            if (it == values_.end()) { return 0; }
+            values_.erase(it);
+            return 1;
+        }
 
-            seen.insert(value);
-            return false;
-        });
+        bool operator==(const flat_set& other) const { return values_ == other.values_; }
+        bool operator!=(const flat_set& other) const { return values_ != other.values_; }
 
-        v.erase(new_end, v.end());
+        // adopts values that are already sorted and unique, skipping the sort
+        static flat_set from_sorted(std::vector<type> values) {
+            flat_set s;
+            s.values_ = std::move(values);
+            return s;
+        }
+
+    private:
+        void normalize() {
+            std::sort(values_.begin(), values_.end(), compare());
+            unique();
+        }
+
+        void unique() {
+            auto equal = [](const type& a, const type& b) { return !compare()(a, b) && !compare()(b, a); };
+            values_.erase(std::unique(values_.begin(), values_.end(), equal), values_.end());
+        }
+
+        std::vector<type> values_;
+    };
+
+    template <typename type, typename compare> inline flat_set<type, compare> set_union(const flat_set<type, compare>& a, const flat_set<type, compare>& b) {
+        std::vector<type> out;
+        out.reserve(a.size() + b.size());
+        std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(out), compare());
+        return flat_set<type, compare>::from_sorted(std::move(out));
+    }
+
+    template <typename type, typename compare> inline flat_set<type, compare> set_intersection(const flat_set<type, compare>& a, const flat_set<type, compare>& b) {
+        std::vector<type> out;
+        out.reserve((std::min)(a.size(), b.size()));
+        std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(out), compare());
+        return flat_set<type, compare>::from_sorted(std::move(out));
+    }
+
+    // values of a that are not in b
+    template <typename type, typename compare> inline flat_set<type, compare> set_difference(const flat_set<type, compare>& a, const flat_set<type, compare>& b) {
+        std::vector<type> out;
+        out.reserve(a.size());
+        std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(out), compare());
+        return flat_set<type, compare>::from_sorted(std::move(out));
     }
 
-    template <typename type> inline bool has(std::vector<type>& v, type item) {
+    // sorts v and drops repeated values; the fastest dedup when the original order does not matter
+    template <typename type> inline void sort_unique(std::vector<type>& v) {
+        std::sort(v.begin(), v.end());
+        v.erase(std::unique(v.begin(), v.end()), v.end());
+    }
+
+    // keeps the first occurrence of every value, in the original order. Short vectors are scanned directly, arithmetic
+    // values go through one open-addressing table, and other types through an unordered_set allocated from resource
+    template <typename type> inline void remove_duplicates(std::vector<type>& v, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+        if (v.size() <= 32) {
+            auto new_end = v.begin();
+            for (auto it = v.begin(); it != v.end(); ++it) {
+                if (std::find(v.begin(), new_end, *it) != new_end) { continue; }
+                if (it != new_end) { *new_end = std::move(*it); }
+                ++new_end;
+            }
+            v.erase(new_end, v.end());
+        } else if constexpr (std::is_arithmetic_v<type>) {
+            owl::hash::flat_map<type, std::uint8_t> seen(v.size());
+            auto new_end = std::remove_if(v.begin(), v.end(), [&seen](const type& value) {
+                return !seen.insert(value, 1).second;
+            });
+            v.erase(new_end, v.end());
+        } else {
+            std::pmr::unordered_set<type> seen(v.size(), resource);
+            auto new_end = std::remove_if(v.begin(), v.end(), [&seen](const type& value) {
+                return !seen.insert(value).second;
+            });
+            v.erase(new_end, v.end());
+        }
+    }
+
+    template <typename type> inline bool has(const std::vector<type>& v, const type& item) {
         return std::find(v.begin(), v.end(), item) != v.end();
     }
+
+    template <typename type, typename compare> inline bool has(const flat_set<type, compare>& s, const type& item) {
+        return s.contains(item);
+    }
 }
 
 #endif
\ No newline at end of file